@@ -0,0 +1,222 @@
+#include "binaryIO.hpp"
+
+namespace parseWiki {
+
+// The vectors find the overloads for their elements, so all are declared here
+static void put(ostream &out, const Numeri &n);
+static void put(ostream &out, const Noun &n);
+static void put(ostream &out, const Verb &v);
+static void put(ostream &out, const Adjective &a);
+static void put(ostream &out, const Adverb &a);
+static void put(ostream &out, const Pronoun &p);
+static void put(ostream &out, const InflectedForm &f);
+static void get(istream &in, Numeri &n);
+static void get(istream &in, Noun &n);
+static void get(istream &in, Verb &v);
+static void get(istream &in, Adjective &a);
+static void get(istream &in, Adverb &a);
+static void get(istream &in, Pronoun &p);
+static void get(istream &in, InflectedForm &f);
+
+void writeBinary(ostream &out, uint64_t v) {
+    out.write(reinterpret_cast<const char *>(&v), sizeof(v));
+}
+static void put(ostream &out, uint64_t v) { writeBinary(out, v); }
+static void put(ostream &out, bool b) { put(out, uint64_t(b)); }
+void writeBinary(ostream &out, const string &s) {
+    put(out, uint64_t(s.size()));
+    out.write(s.data(), s.size());
+}
+static void put(ostream &out, const string &s) { writeBinary(out, s); }
+template <typename T> static void put(ostream &out, const vector<T> &v) {
+    put(out, uint64_t(v.size()));
+    for (const T &e : v)
+        put(out, e);
+}
+static void put(ostream &out, const Numeri &n) {
+    put(out, n.singular);
+    put(out, n.plural);
+}
+static void put(ostream &out, const Person &p) {
+    put(out, p.first);
+    put(out, p.second);
+    put(out, p.third);
+}
+static void put(ostream &out, const WithCases &c) {
+    for (size_t i = 0; i < 4; i++)
+        put(out, c.cases[i]);
+}
+static void put(ostream &out, const Noun &n) {
+    put(out, (const WithCases &)n);
+    put(out, n.noPlural);
+    put(out, n.noSingular);
+    put(out, uint64_t(n.type));
+    put(out, n.genus.m);
+    put(out, n.genus.n);
+    put(out, n.genus.f);
+}
+static void put(ostream &out, const Verb &v) {
+    put(out, v.base.presentInfinitive);
+    put(out, v.base.present);
+    put(out, v.base.participleII);
+    put(out, v.base.subjunctive_firstSingular);
+    put(out, v.base.irrealis_firstSingular);
+    put(out, v.base.preterite_firstSingular);
+    put(out, v.base.auxiliary);
+    put(out, v.imperative);
+}
+static void put(ostream &out, const Adjective &a) {
+    put(out, a.positive);
+    put(out, a.comparative);
+    put(out, a.superlative);
+    for (size_t i = 0; i < 9; i++)
+        put(out, a.cases[i]);
+}
+static void put(ostream &out, const Adverb &a) {
+    put(out, a.positive);
+    put(out, a.comparative);
+    put(out, a.superlative);
+    put(out, uint64_t(a.type));
+}
+static void put(ostream &out, const Pronoun &p) {
+    put(out, uint64_t(p.type));
+    put(out, (const WithCases &)p);
+}
+static void put(ostream &out, const InflectedForm &f) {
+    put(out, f.form);
+    put(out, f.lemma);
+    put(out, uint64_t(f.slots));
+    put(out, uint64_t(f.detail));
+    put(out, f.formIsKey);
+}
+void writeBinary(ostream &out, const Dictionary &d) {
+    put(out, d.nouns);
+    put(out, d.verbs);
+    put(out, d.adjectives);
+    put(out, d.adverbs);
+    put(out, d.pronouns);
+}
+void writeBinary(ostream &out, const Noun &n) { put(out, n); }
+void writeBinary(ostream &out, const Verb &v) { put(out, v); }
+void writeBinary(ostream &out, const Adjective &a) { put(out, a); }
+void writeBinary(ostream &out, const Adverb &a) { put(out, a); }
+void writeBinary(ostream &out, const Pronoun &p) { put(out, p); }
+void writeBinary(ostream &out, const InflectedForm &f) { put(out, f); }
+void writeBinary(ostream &out, const FormIndex &f) {
+    put(out, f.nouns);
+    put(out, f.verbs);
+    put(out, f.adjectives);
+    put(out, f.pronouns);
+}
+
+uint64_t readNumber(istream &in) {
+    uint64_t v;
+    if (!in.read(reinterpret_cast<char *>(&v), sizeof(v)))
+        throw Exception("Unexpected end of a binary file");
+    return v;
+}
+static void get(istream &in, uint64_t &v) { v = readNumber(in); }
+uint64_t readSize(istream &in) {
+    const uint64_t size = readNumber(in);
+    if (size > 1024 * 1024 * 1024)
+        throw Exception("Corrupt binary file");
+    return size;
+}
+static void get(istream &in, bool &b) {
+    uint64_t v;
+    get(in, v);
+    b = v != 0;
+}
+void readBinary(istream &in, string &s) {
+    s.resize(readSize(in));
+    if (!in.read(&s[0], s.size()))
+        throw Exception("Unexpected end of a binary file");
+}
+static void get(istream &in, string &s) { readBinary(in, s); }
+template <typename E> static void getEnum(istream &in, E &e) {
+    uint64_t v;
+    get(in, v);
+    e = E(v);
+}
+template <typename T> static void get(istream &in, vector<T> &v) {
+    v.resize(readSize(in));
+    for (T &e : v)
+        get(in, e);
+}
+static void get(istream &in, Numeri &n) {
+    get(in, n.singular);
+    get(in, n.plural);
+}
+static void get(istream &in, Person &p) {
+    get(in, p.first);
+    get(in, p.second);
+    get(in, p.third);
+}
+static void get(istream &in, WithCases &c) {
+    for (size_t i = 0; i < 4; i++)
+        get(in, c.cases[i]);
+}
+static void get(istream &in, Noun &n) {
+    get(in, (WithCases &)n);
+    get(in, n.noPlural);
+    get(in, n.noSingular);
+    getEnum(in, n.type);
+    get(in, n.genus.m);
+    get(in, n.genus.n);
+    get(in, n.genus.f);
+}
+static void get(istream &in, Verb &v) {
+    get(in, v.base.presentInfinitive);
+    get(in, v.base.present);
+    get(in, v.base.participleII);
+    get(in, v.base.subjunctive_firstSingular);
+    get(in, v.base.irrealis_firstSingular);
+    get(in, v.base.preterite_firstSingular);
+    get(in, v.base.auxiliary);
+    get(in, v.imperative);
+}
+static void get(istream &in, Adjective &a) {
+    get(in, a.positive);
+    get(in, a.comparative);
+    get(in, a.superlative);
+    for (size_t i = 0; i < 9; i++)
+        get(in, a.cases[i]);
+}
+static void get(istream &in, Adverb &a) {
+    get(in, a.positive);
+    get(in, a.comparative);
+    get(in, a.superlative);
+    getEnum(in, a.type);
+}
+static void get(istream &in, Pronoun &p) {
+    getEnum(in, p.type);
+    get(in, (WithCases &)p);
+}
+static void get(istream &in, InflectedForm &f) {
+    get(in, f.form);
+    get(in, f.lemma);
+    f.slots = uint32_t(readNumber(in));
+    f.detail = uint8_t(readNumber(in));
+    get(in, f.formIsKey);
+}
+void readBinary(istream &in, Dictionary &d) {
+    get(in, d.nouns);
+    get(in, d.verbs);
+    get(in, d.adjectives);
+    get(in, d.adverbs);
+    get(in, d.pronouns);
+}
+void readBinary(istream &in, Noun &n) { get(in, n); }
+void readBinary(istream &in, Verb &v) { get(in, v); }
+void readBinary(istream &in, Adjective &a) { get(in, a); }
+void readBinary(istream &in, Adverb &a) { get(in, a); }
+void readBinary(istream &in, Pronoun &p) { get(in, p); }
+void readBinary(istream &in, InflectedForm &f) { get(in, f); }
+void readBinary(istream &in, FormIndex &f) {
+    get(in, f.nouns);
+    get(in, f.verbs);
+    get(in, f.adjectives);
+    get(in, f.pronouns);
+}
+
+} // namespace parseWiki
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <string>
+using std::istream, std::ostream;
+using std::string;
+
+#include "dictionary.hpp"
+#include "formIndex.hpp"
+#include "util.hpp"
+
+namespace parseWiki {
+
+// Binary files for the intermediate state of parseWiki. Everything is written
+// as it is in memory with the sizes as 64 bit numbers, so the files are only
+// meant to be read back on the machine that wrote them. Unlike
+// Dictionary::serialize, every field of the entries is kept.
+
+void writeBinary(ostream &out, uint64_t v);
+void writeBinary(ostream &out, const string &s);
+void writeBinary(ostream &out, const Dictionary &d);
+void writeBinary(ostream &out, const Noun &n);
+void writeBinary(ostream &out, const Verb &v);
+void writeBinary(ostream &out, const Adjective &a);
+void writeBinary(ostream &out, const Adverb &a);
+void writeBinary(ostream &out, const Pronoun &p);
+void writeBinary(ostream &out, const InflectedForm &f);
+void writeBinary(ostream &out, const FormIndex &f);
+
+// These throw an Exception if the file ends early or looks corrupt
+uint64_t readNumber(istream &in);
+uint64_t readSize(istream &in); // A number of elements, checked for sanity
+void readBinary(istream &in, string &s);
+void readBinary(istream &in, Dictionary &d);
+void readBinary(istream &in, Noun &n);
+void readBinary(istream &in, Verb &v);
+void readBinary(istream &in, Adjective &a);
+void readBinary(istream &in, Adverb &a);
+void readBinary(istream &in, Pronoun &p);
+void readBinary(istream &in, InflectedForm &f);
+void readBinary(istream &in, FormIndex &f);
+
+static const char binaryEndMark[4] = {'E', 'N', 'D', '!'};
+
+// Writes magic, whatever write writes and an end mark. The file is written
+// next to path first and then moved over it, so a crash while writing keeps
+// the previous one.
+template <typename F>
+void writeBinaryFile(const string &path, const char (&magic)[8], F write) {
+    const string temp = path + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out.good())
+            throw Exception("Can't write " + temp);
+        out.write(magic, sizeof(magic));
+        write(out);
+        out.write(binaryEndMark, sizeof(binaryEndMark));
+        if (!out.flush())
+            throw Exception("Can't write " + temp);
+    }
+    // rename doesn't replace existing files everywhere
+    std::remove(path.c_str());
+    if (std::rename(temp.c_str(), path.c_str()) != 0)
+        throw Exception("Can't rename " + temp + " to " + path);
+}
+
+// Reads a file written by writeBinaryFile with read. Returns false if there is
+// none.
+template <typename F>
+bool readBinaryFile(const string &path, const char (&magic)[8], F read) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.good())
+        return false;
+    char head[sizeof(magic)];
+    if (!in.read(head, sizeof(head)) ||
+        !std::equal(head, head + sizeof(head), magic))
+        throw Exception(path + " is of another kind or version");
+    read(in);
+    char tail[sizeof(binaryEndMark)];
+    if (!in.read(tail, sizeof(tail)) ||
+        !std::equal(tail, tail + sizeof(tail), binaryEndMark))
+        throw Exception(path + " is truncated");
+    return true;
+}
+
+} // namespace parseWiki
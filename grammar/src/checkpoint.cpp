@@ -0,0 +1,71 @@
+#include "checkpoint.hpp"
+
+#include <cstdio>
+
+#include "binaryIO.hpp"
+
+namespace parseWiki {
+
+static const char magic[8] = {'P', 'W', 'C', 'K', 'P', 'T', '0', '5'};
+
+void saveCheckpoint(const string &path, const Checkpoint &cp,
+                    const PageShard &state) {
+    // If we crash while replacing path, loadCheckpoint picks up the complete
+    // temporary file
+    writeBinaryFile(path, magic, [&](ostream &out) {
+        writeBinary(out, cp.source);
+        writeBinary(out, cp.pages);
+        writeBinary(out, cp.at.offset);
+        writeBinary(out, cp.at.stream);
+        writeBinary(out, cp.at.streamStart);
+        writeBinary(out, cp.runs);
+        writeBinary(out, state.wordClasses.size());
+        for (const auto &wc : state.wordClasses) {
+            writeBinary(out, wc.first);
+            writeBinary(out, wc.second);
+        }
+        writeRecords(out, state.records);
+        writeBinary(out, state.dict);
+        writeBinary(out, state.forms);
+    });
+}
+
+static bool loadFrom(const string &path, Checkpoint &cp, PageShard &state) {
+    return readBinaryFile(path, magic, [&](istream &in) {
+        cp.source = readNumber(in);
+        cp.pages = readNumber(in);
+        cp.at.offset = readNumber(in);
+        cp.at.stream = readNumber(in);
+        cp.at.streamStart = readNumber(in);
+        cp.runs = readNumber(in);
+        state.wordClasses.clear();
+        for (uint64_t n = readSize(in); n > 0; n--) {
+            string wc;
+            readBinary(in, wc);
+            state.wordClasses[wc] = readNumber(in);
+        }
+        readRecords(in, state.records);
+        readBinary(in, state.dict);
+        readBinary(in, state.forms);
+    });
+}
+
+bool loadCheckpoint(const string &path, Checkpoint &cp, PageShard &state) {
+    if (loadFrom(path, cp, state))
+        return true;
+    // Left behind by a crash, complete if it happened while replacing path
+    try {
+        return loadFrom(path + ".tmp", cp, state);
+    } catch (Exception &) {
+        cp = Checkpoint();
+        state = PageShard();
+        return false;
+    }
+}
+
+void removeCheckpoint(const string &path) {
+    std::remove(path.c_str());
+    std::remove((path + ".tmp").c_str());
+}
+
+} // namespace parseWiki
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+using std::string;
+
+#include "pageStore.hpp"
+#include "wikiReader.hpp"
+
+namespace parseWiki {
+
+// Where and how often parseWiki saves its progress
+struct Checkpointing {
+    string path; // No checkpoints if empty, resumes if there is one already
+    size_t everyPages = 100000;
+};
+
+// How far an unfinished run got
+struct Checkpoint {
+    size_t source = 0; // Size of the dump it belongs to, 0 if unknown
+    size_t pages = 0;  // Pages read, including the skipped ones
+    ResumePoint at;    // Where to continue reading
+    size_t runs = 0;   // Entries spilled to run files in front of the state
+};
+
+// Writes the state next to path and then replaces path with it, so a crash
+// while writing keeps the previous checkpoint. The format is the one of
+// binaryIO.hpp, it is only meant to be read back by the same build.
+void saveCheckpoint(const string &path, const Checkpoint &cp,
+                    const PageShard &state);
+
+// Returns false if there is no checkpoint at path
+bool loadCheckpoint(const string &path, Checkpoint &cp, PageShard &state);
+
+// Deletes the checkpoint once the run is complete
+void removeCheckpoint(const string &path);
+
+} // namespace parseWiki
@@ -0,0 +1,173 @@
+#include "chunkIndex.hpp"
+
+#include <algorithm>
+#include <istream>
+#include <vector>
+using std::istream;
+using std::vector;
+
+#include "binaryIO.hpp"
+#include "dictionaryReader.hpp"
+#include "mappedFile.hpp"
+#include "util.hpp"
+
+namespace parseWiki {
+
+static const char magic[8] = {'P', 'W', 'C', 'H', 'N', 'K', '0', '1'};
+
+static const size_t classes = 5;
+
+struct ClassChunks {
+    uint64_t at = 0;    // Where its count starts
+    uint64_t count = 0; // Of entries
+    vector<uint64_t> chunks;
+};
+
+template <typename T>
+static void serializeClass(ostream &out, const vector<T> &entries,
+                           size_t chunk, ClassChunks &index) {
+    index.at = uint64_t(out.tellp());
+    index.count = entries.size();
+    // The same as serializeVector
+    out << entries.size() << "\n";
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (i % chunk == 0)
+            index.chunks.push_back(uint64_t(out.tellp()));
+        entries[i].serialize(out);
+        out << "\n";
+    }
+}
+
+void serializeChunked(ostream &out, const Dictionary &dict,
+                      const string &indexPath, size_t chunk) {
+    if (chunk == 0)
+        throw Exception("Chunks need entries");
+    ClassChunks index[classes];
+    serializeClass(out, dict.nouns, chunk, index[0]);
+    serializeClass(out, dict.verbs, chunk, index[1]);
+    serializeClass(out, dict.adjectives, chunk, index[2]);
+    serializeClass(out, dict.adverbs, chunk, index[3]);
+    serializeClass(out, dict.pronouns, chunk, index[4]);
+    const uint64_t size = uint64_t(out.tellp());
+    if (!out || index[0].at == uint64_t(-1))
+        throw Exception("Can't tell where the chunks of " + indexPath +
+                        " start");
+
+    writeBinaryFile(indexPath, magic, [&](ostream &file) {
+        writeBinary(file, uint64_t(chunk));
+        writeBinary(file, size);
+        for (const ClassChunks &c : index) {
+            writeBinary(file, c.at);
+            writeBinary(file, c.count);
+            writeBinary(file, uint64_t(c.chunks.size()));
+            for (const uint64_t at : c.chunks)
+                writeBinary(file, at);
+        }
+    });
+}
+
+// Parses the chunk between the offsets from and to into entries and checks
+// that all of it was used
+template <typename T>
+static void deserializeChunk(const MappedFile &file, uint64_t from,
+                             uint64_t to, T *entries, size_t count,
+                             const string &path) {
+    DictionaryReader reader(file.view(), path, from, to);
+    for (size_t i = 0; i < count; i++)
+        reader.read(entries[i]);
+    if (!reader.atEnd())
+        throw Exception(path + " doesn't fit its chunk index");
+}
+
+// Checks the count of a word class and makes room for its entries
+template <typename T>
+static void prepareClass(const MappedFile &file, const ClassChunks &index,
+                         uint64_t end, vector<T> &entries,
+                         const string &path) {
+    DictionaryReader reader(file.view(), path, index.at, end);
+    const size_t count = reader.readSize();
+    if (count != index.count)
+        throw Exception(path + " doesn't fit its chunk index");
+    entries.clear();
+    entries.resize(count);
+}
+
+template <typename T>
+static void deserializeClass(const MappedFile &file, const ClassChunks &index,
+                             uint64_t end, uint64_t chunk, vector<T> &entries,
+                             ThreadPool &pool, const string &path) {
+    for (size_t c = 0; c < index.chunks.size(); c++) {
+        const uint64_t from = index.chunks[c];
+        const uint64_t to =
+            c + 1 < index.chunks.size() ? index.chunks[c + 1] : end;
+        const size_t begin = c * chunk;
+        const size_t size = std::min<size_t>(chunk, entries.size() - begin);
+        T *into = entries.data() + begin;
+        pool.add([=, &file, &path]() {
+            deserializeChunk(file, from, to, into, size, path);
+        });
+    }
+}
+
+void deserializeChunked(const string &path, const string &indexPath,
+                        Dictionary &dict, ThreadPool &pool) {
+    MappedFile file(path);
+    uint64_t chunk = 0;
+    ClassChunks index[classes];
+    const bool found = readBinaryFile(indexPath, magic, [&](istream &in) {
+        chunk = readNumber(in);
+        const uint64_t size = readNumber(in);
+        if (chunk == 0 || size != file.size())
+            throw Exception(indexPath + " is the index of another file");
+        uint64_t last = 0;
+        for (ClassChunks &c : index) {
+            c.at = readNumber(in);
+            c.count = readNumber(in);
+            c.chunks.resize(readSize(in));
+            if (c.chunks.size() != (c.count + chunk - 1) / chunk)
+                throw Exception(indexPath + " is corrupt");
+            // Everything in the order of the file
+            if (c.at < last)
+                throw Exception(indexPath + " is corrupt");
+            last = c.at;
+            for (uint64_t &at : c.chunks) {
+                at = readNumber(in);
+                if (at <= last)
+                    throw Exception(indexPath + " is corrupt");
+                last = at;
+            }
+        }
+        if (last > size)
+            throw Exception(indexPath + " is corrupt");
+    });
+    if (!found)
+        throw Exception("Can't read " + indexPath);
+
+    // A word class ends where the next one starts
+    auto end = [&](size_t c) {
+        return c + 1 < classes ? index[c + 1].at : uint64_t(file.size());
+    };
+    // Nothing is added to the pool before all counts are known to fit, so
+    // no task is left reading the file when this throws
+    prepareClass(file, index[0], end(0), dict.nouns, path);
+    prepareClass(file, index[1], end(1), dict.verbs, path);
+    prepareClass(file, index[2], end(2), dict.adjectives, path);
+    prepareClass(file, index[3], end(3), dict.adverbs, path);
+    prepareClass(file, index[4], end(4), dict.pronouns, path);
+    deserializeClass(file, index[0], end(0), chunk, dict.nouns, pool, path);
+    deserializeClass(file, index[1], end(1), chunk, dict.verbs, pool, path);
+    deserializeClass(file, index[2], end(2), chunk, dict.adjectives, pool,
+                     path);
+    deserializeClass(file, index[3], end(3), chunk, dict.adverbs, pool, path);
+    deserializeClass(file, index[4], end(4), chunk, dict.pronouns, pool,
+                     path);
+    pool.wait();
+}
+
+void deserializeChunked(const string &path, const string &indexPath,
+                        Dictionary &dict) {
+    ThreadPool pool;
+    deserializeChunked(path, indexPath, dict, pool);
+}
+
+} // namespace parseWiki
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+using std::ostream;
+using std::string;
+
+#include "dictionary.hpp"
+#include "threadPool.hpp"
+
+namespace parseWiki {
+
+// Where the chunks of entries of every word class start in a file written by
+// Dictionary::serialize, so that the chunks can be parsed on all cores. The
+// text file stays as it is; the offsets go to an index file of their own:
+//
+//   magic, entries per chunk, size of the text file     8 bytes each
+//   for every word class: where its count starts, the count, the number of
+//     chunks and where every chunk starts
+//   end mark
+
+// Writes dict to out the way Dictionary::serialize does and the index of the
+// chunks to indexPath. out must tell its position, like a file does.
+void serializeChunked(ostream &out, const Dictionary &dict,
+                      const string &indexPath, size_t chunk = 1024);
+
+// Reads a file written by serializeChunked into dict, the chunks of every
+// word class in parallel into vectors of the right size. Throws an Exception
+// if the index is missing or doesn't fit the file, for example because the
+// file was written again without it.
+void deserializeChunked(const string &path, const string &indexPath,
+                        Dictionary &dict, ThreadPool &pool);
+void deserializeChunked(const string &path, const string &indexPath,
+                        Dictionary &dict);
+
+} // namespace parseWiki
@@ -0,0 +1,145 @@
+#include "diagnostics.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+using std::cout, std::endl;
+
+static const char *problemNames[] = {
+    "Collection failed",
+    "unknown prop subs",
+    "unknown prop verb",
+    "unknown prop adj",
+    "unknown prop adv",
+    "unknown prop",
+    "empty",
+    "unknown pronoun",
+    "unknown adverb",
+    "unknown class",
+    "unknown field",
+    "Multiple Plural declarations",
+    "unknown case",
+    "unknown Noun/Adjective Declination",
+    "unknown person",
+    "unexpected number",
+    "unknown mode",
+    "Couldn't set",
+    "unknown 'deklinierte Form'",
+    "nominative needed",
+    "Singular doesn't exist",
+    "First Person needed",
+    "can't use 'any' here",
+    "TODO: person not supported",
+    "TODO: unknown tempus",
+    "TODO: unknown mode",
+    "invalid UTF-8",
+};
+static_assert(sizeof(problemNames) / sizeof(problemNames[0]) ==
+                  size_t(Problem::count),
+              "a problem has no name");
+
+static thread_local string_view diagnosedTitle;
+
+Diagnostics::Diagnostics(ostream &log) : log(&log) {}
+
+Diagnostics::~Diagnostics() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    if (writer.joinable())
+        writer.join();
+}
+
+void Diagnostics::write() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        changed.wait(lock, [&]() { return !lines.empty() || stopping; });
+        if (lines.empty())
+            return;
+        std::deque<string> taken;
+        taken.swap(lines);
+        writing = true;
+        lock.unlock();
+        for (const string &line : taken)
+            *log << line << '\n';
+        log->flush();
+        lock.lock();
+        writing = false;
+        changed.notify_all();
+    }
+}
+
+void Diagnostics::report(Problem problem,
+                         std::initializer_list<string_view> detail) {
+    const size_t p = size_t(problem);
+    const uint64_t before = counts[p]++;
+    if (before >= std::max(logged, sampled))
+        return;
+
+    string what;
+    for (const string_view part : detail)
+        what += part;
+    string line = "Error: ";
+    line += problemNames[p];
+    if (!what.empty()) {
+        line += ": ";
+        line += what;
+    }
+    if (!diagnosedTitle.empty()) {
+        line += " [";
+        line += diagnosedTitle;
+        line += "]";
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const string_view sample =
+            diagnosedTitle.empty() ? string_view(what) : diagnosedTitle;
+        if (samples[p].size() < sampled &&
+            (samples[p].empty() || samples[p].back() != sample))
+            samples[p].emplace_back(sample);
+        if (before < logged) {
+            lines.push_back(std::move(line));
+            if (!writer.joinable())
+                writer = std::thread([this]() { write(); });
+        }
+    }
+    changed.notify_all();
+}
+
+void Diagnostics::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [&]() { return lines.empty() && !writing; });
+}
+
+void Diagnostics::summary(ostream &out) {
+    flush();
+    std::lock_guard<std::mutex> lock(mutex);
+    bool any = false;
+    for (size_t p = 0; p < problems; p++) {
+        const uint64_t count = counts[p].load();
+        if (count == 0)
+            continue;
+        if (!any)
+            out << endl << std::setw(10) << "count" << "  problem" << endl;
+        any = true;
+        out << std::setw(10) << count << "  " << problemNames[p];
+        for (size_t i = 0; i < samples[p].size(); i++)
+            out << (i == 0 ? ": " : ", ") << samples[p][i];
+        if (count > samples[p].size())
+            out << ", ...";
+        out << endl;
+    }
+}
+
+Diagnostics &diagnostics() {
+    static Diagnostics all(cout);
+    return all;
+}
+
+Diagnosing::Diagnosing(string_view title) : previous(diagnosedTitle) {
+    diagnosedTitle = title;
+}
+
+Diagnosing::~Diagnosing() { diagnosedTitle = previous; }
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+using std::ostream;
+using std::string, std::string_view;
+using std::vector;
+
+// What went wrong while parsing the dump or inflecting a word
+enum class Problem {
+    collectionFailed,
+    unknownNounProp,
+    unknownVerbProp,
+    unknownAdjectiveProp,
+    unknownAdverbProp,
+    unknownPronounProp,
+    emptyEntry,
+    unknownPronoun,
+    unknownAdverb,
+    unknownClass,
+    unknownField,
+    multiplePlurals,
+    unknownCase,
+    unknownDeclination,
+    unknownPerson,
+    unexpectedNumber,
+    unknownMode,
+    unsetForm,
+    unknownDeclinedForm,
+    noNominative,
+    noSingular,
+    noFirstPerson,
+    anyPersonOrNumber,
+    unsupportedPerson,
+    unsupportedTempus,
+    unsupportedMode,
+    invalidUTF8,
+    count
+};
+
+// Counts the problems of every kind and keeps the titles of the first pages
+// they came up in. Only the first ones of a kind are written to the log, by a
+// thread of its own, so the others cost an atomic increment and no locking or
+// I/O in the parse and inflection loops.
+class Diagnostics {
+  private:
+    static const size_t problems = size_t(Problem::count);
+    std::atomic<uint64_t> counts[problems] = {};
+    vector<string> samples[problems];
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<string> lines; // Not written yet
+    std::thread writer;
+    bool writing = false;     // A line was taken but isn't written yet
+    bool stopping = false;
+
+    void write();
+
+  public:
+    ostream *log;
+    size_t logged = 20; // Problems of every kind written to log
+    size_t sampled = 5; // Titles of every kind kept for the summary
+
+    explicit Diagnostics(ostream &log);
+    ~Diagnostics();
+    Diagnostics(const Diagnostics &) = delete;
+    Diagnostics &operator=(const Diagnostics &) = delete;
+
+    // The parts of detail tell what was wrong and are only put together when
+    // it is logged. The title is taken from the Diagnosing on this thread.
+    void report(Problem problem, std::initializer_list<string_view> detail);
+
+    // Waits until everything reported so far is in the log
+    void flush();
+
+    // The count of every kind of problem that came up, with its first titles
+    void summary(ostream &out);
+};
+
+// The diagnostics of the process, logging to cout
+Diagnostics &diagnostics();
+
+template <typename... Parts>
+void diagnose(Problem problem, const Parts &...detail) {
+    diagnostics().report(problem, {string_view(detail)...});
+}
+
+// Names the page the problems reported on this thread belong to until it is
+// destroyed
+class Diagnosing {
+  private:
+    string_view previous;
+
+  public:
+    explicit Diagnosing(string_view title);
+    ~Diagnosing();
+    Diagnosing(const Diagnosing &) = delete;
+    Diagnosing &operator=(const Diagnosing &) = delete;
+};
@@ -1,8 +1,11 @@
 #pragma once
+#include <atomic>
+
 #include "adjective.hpp"
 #include "adverb.hpp"
 #include "noun.hpp"
 #include "pronoun.hpp"
+#include "threadPool.hpp"
 #include "verb.hpp"
 
 /*
@@ -29,6 +32,15 @@ class Dictionary {
     void add(const Adverb &adv) { adverbs.push_back(adv); }
     void add(const Pronoun &prn) { pronouns.push_back(prn); }
 
+    // Moves all entries of other behind the own ones
+    void append(Dictionary &&other) {
+        appendVector(nouns, other.nouns);
+        appendVector(verbs, other.verbs);
+        appendVector(adjectives, other.adjectives);
+        appendVector(adverbs, other.adverbs);
+        appendVector(pronouns, other.pronouns);
+    }
+
     size_t size() {
         return nouns.size() + verbs.size() + adjectives.size() +
                adverbs.size() + pronouns.size();
@@ -49,6 +61,15 @@ class Dictionary {
             pro.buildMap(dict);
     }
 
+    // The map of buildMap, for saving it with the entries
+    const map<string, vector<Word>> &formMap() const { return dict; }
+
+    // Takes a map that buildMap would build from the entries, instead of
+    // building it
+    void adoptMap(map<string, vector<Word>> &&built) {
+        dict = std::move(built);
+    }
+
     vector<Word> find(const stringLower &what) const {
         auto res = dict.find(what);
         if (res == dict.end())
@@ -72,6 +93,13 @@ class Dictionary {
     }
 
   private:
+    template <typename T>
+    static void appendVector(vector<T> &to, vector<T> &from) {
+        to.insert(to.end(), std::make_move_iterator(from.begin()),
+                  std::make_move_iterator(from.end()));
+        from.clear();
+    }
+
     static size_t stripEmpty(WithCases &wc) {
         size_t stripped = 0;
         for (size_t i = 0; i < 4; i++) {
@@ -87,39 +115,62 @@ class Dictionary {
         return removeWhere(n.singular, "") + removeWhere(n.plural, "");
     }
 
+    static size_t stripEmpty(Adjective &adj) {
+        size_t stripped = 0;
+        for (size_t i = 0; i < 9; i++)
+            stripped += stripEmpty(adj.cases[i]);
+        return stripped + removeWhere(adj.positive, "") +
+               removeWhere(adj.comparative, "") +
+               removeWhere(adj.superlative, "");
+    }
+    static size_t stripEmpty(Verb &verb) {
+        return stripEmpty(verb.imperative) + stripEmpty(verb.base.present) +
+               removeWhere(verb.base.auxiliary, "") +
+               removeWhere(verb.base.irrealis_firstSingular, "") +
+               removeWhere(verb.base.participleII, "") +
+               removeWhere(verb.base.presentInfinitive, "") +
+               removeWhere(verb.base.preterite_firstSingular, "") +
+               removeWhere(verb.base.subjunctive_firstSingular, "");
+    }
+    static size_t stripEmpty(Adverb &adv) {
+        return removeWhere(adv.positive, "") +
+               removeWhere(adv.comparative, "") +
+               removeWhere(adv.superlative, "");
+    }
+
+    // Strips the entries of a word class in chunks on the pool
+    template <typename T>
+    static void stripEmpty(ThreadPool &pool, vector<T> &entries,
+                           std::atomic<size_t> &stripped) {
+        pool.addChunks(entries.size(), [&](size_t begin, size_t end) {
+            size_t here = 0;
+            for (size_t i = begin; i < end; i++)
+                here += stripEmpty(entries[i]);
+            stripped += here;
+        });
+    }
+
   public:
-    void simplify() {
-        size_t emptyRemoved = 0;
-        for (Noun &noun : nouns)
-            emptyRemoved += stripEmpty(noun);
-        for (Adjective &adj : adjectives) {
-            for (size_t i = 0; i < 9; i++)
-                emptyRemoved += stripEmpty(adj.cases[i]);
-            emptyRemoved += removeWhere(adj.positive, "") +
-                            removeWhere(adj.comparative, "") +
-                            removeWhere(adj.superlative, "");
-        }
-        for (Verb &verb : verbs) {
-            emptyRemoved +=
-                stripEmpty(verb.imperative) + stripEmpty(verb.base.present) +
-                removeWhere(verb.base.auxiliary, "") +
-                removeWhere(verb.base.irrealis_firstSingular, "") +
-                removeWhere(verb.base.participleII, "") +
-                removeWhere(verb.base.presentInfinitive, "") +
-                removeWhere(verb.base.preterite_firstSingular, "") +
-                removeWhere(verb.base.subjunctive_firstSingular, "");
-        }
-        for (Adverb &adv : adverbs) {
-            emptyRemoved += removeWhere(adv.positive, "") +
-                            removeWhere(adv.comparative, "") +
-                            removeWhere(adv.superlative, "");
-        }
-        for (Pronoun &pro : pronouns)
-            emptyRemoved += stripEmpty(pro);
+    // Removes the empty forms of one entry, returns how many
+    template <typename T> static size_t simplifyEntry(T &entry) {
+        return stripEmpty(entry);
+    }
 
-        cout << "   removed empty: " << emptyRemoved << endl;
+    // Every entry is simplified on its own, so they are spread over the pool
+    void simplify(ThreadPool &pool) {
+        std::atomic<size_t> emptyRemoved(0);
+        stripEmpty(pool, nouns, emptyRemoved);
+        stripEmpty(pool, adjectives, emptyRemoved);
+        stripEmpty(pool, verbs, emptyRemoved);
+        stripEmpty(pool, adverbs, emptyRemoved);
+        stripEmpty(pool, pronouns, emptyRemoved);
+        pool.wait();
 
-        
+        cout << "   removed empty: " << emptyRemoved << endl;
+    }
+    void simplify() {
+        ThreadPool pool;
+        simplify(pool);
     }
 
     void serialize(ostream &out) const {
@@ -0,0 +1,552 @@
+#include "dictionaryFile.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+using std::vector;
+
+#include "binaryIO.hpp"
+#include "util.hpp"
+
+namespace parseWiki {
+
+static const char magic[8] = {'P', 'W', 'D', 'I', 'C', 'T', '0', '1'};
+
+// The records are written and mapped as they are, so they must not change
+// with the compiler
+static_assert(sizeof(FormList) == 8 && sizeof(NounRecord) == 68 &&
+                  sizeof(VerbRecord) == 112 &&
+                  sizeof(AdjectiveRecord) == 600 &&
+                  sizeof(AdverbRecord) == 28 && sizeof(PronounRecord) == 68,
+              "the records have padding");
+static_assert(std::is_trivially_copyable<NounRecord>::value &&
+                  std::is_trivially_copyable<VerbRecord>::value &&
+                  std::is_trivially_copyable<AdjectiveRecord>::value &&
+                  std::is_trivially_copyable<AdverbRecord>::value &&
+                  std::is_trivially_copyable<PronounRecord>::value,
+              "the records are mapped");
+
+// Calls f with every list of forms of an entry and the FormList of the record
+// that stands for it
+template <typename E, typename F>
+static void eachCase(E &entry, FormList (&cases)[4][2], F f) {
+    for (size_t c = 0; c < 4; c++) {
+        f(entry.cases[c].singular, cases[c][0]);
+        f(entry.cases[c].plural, cases[c][1]);
+    }
+}
+template <typename E, typename F>
+static void eachList(E &noun, NounRecord &record, F f) {
+    eachCase(noun, record.cases, f);
+}
+template <typename E, typename F>
+static void eachList(E &verb, VerbRecord &record, F f) {
+    f(verb.base.presentInfinitive, record.presentInfinitive);
+    f(verb.base.present.first.singular, record.present[0][0]);
+    f(verb.base.present.first.plural, record.present[0][1]);
+    f(verb.base.present.second.singular, record.present[1][0]);
+    f(verb.base.present.second.plural, record.present[1][1]);
+    f(verb.base.present.third.singular, record.present[2][0]);
+    f(verb.base.present.third.plural, record.present[2][1]);
+    f(verb.base.participleII, record.participleII);
+    f(verb.base.subjunctive_firstSingular, record.subjunctive_firstSingular);
+    f(verb.base.irrealis_firstSingular, record.irrealis_firstSingular);
+    f(verb.base.preterite_firstSingular, record.preterite_firstSingular);
+    f(verb.base.auxiliary, record.auxiliary);
+    f(verb.imperative.singular, record.imperative[0]);
+    f(verb.imperative.plural, record.imperative[1]);
+}
+template <typename E, typename F>
+static void eachList(E &adj, AdjectiveRecord &record, F f) {
+    f(adj.positive, record.positive);
+    f(adj.comparative, record.comparative);
+    f(adj.superlative, record.superlative);
+    for (size_t i = 0; i < 9; i++)
+        eachCase(adj.cases[i], record.cases[i], f);
+}
+template <typename E, typename F>
+static void eachList(E &adv, AdverbRecord &record, F f) {
+    f(adv.positive, record.positive);
+    f(adv.comparative, record.comparative);
+    f(adv.superlative, record.superlative);
+}
+template <typename E, typename F>
+static void eachList(E &pronoun, PronounRecord &record, F f) {
+    eachCase(pronoun, record.cases, f);
+}
+
+// The other fields
+static void copyFields(const Noun &noun, NounRecord &record) {
+    record.type = uint8_t(noun.type);
+    record.genus = uint8_t(noun.genus.m | noun.genus.n << 1 |
+                           noun.genus.f << 2);
+    record.noSingular = noun.noSingular;
+    record.noPlural = noun.noPlural;
+}
+static void copyFields(const NounRecord &record, Noun &noun) {
+    noun.type = NounType(record.type);
+    noun.genus.m = record.genus & 1;
+    noun.genus.n = record.genus & 2;
+    noun.genus.f = record.genus & 4;
+    noun.noSingular = record.noSingular;
+    noun.noPlural = record.noPlural;
+}
+static void copyFields(const Verb &, VerbRecord &) {}
+static void copyFields(const VerbRecord &, Verb &) {}
+static void copyFields(const Adjective &, AdjectiveRecord &) {}
+static void copyFields(const AdjectiveRecord &, Adjective &) {}
+static void copyFields(const Adverb &adv, AdverbRecord &record) {
+    record.type = uint32_t(adv.type);
+}
+static void copyFields(const AdverbRecord &record, Adverb &adv) {
+    adv.type = AdverbType(record.type);
+}
+static void copyFields(const Pronoun &pronoun, PronounRecord &record) {
+    record.type = uint32_t(pronoun.type);
+}
+static void copyFields(const PronounRecord &record, Pronoun &pronoun) {
+    pronoun.type = pronounType(record.type);
+}
+
+// The sections of a file being written
+class DictionaryBuilder {
+  private:
+    std::unordered_map<string_view, uint32_t> numbers;
+
+  public:
+    vector<uint64_t> stringAt = {0};
+    string text;
+    vector<uint32_t> listed;
+
+    uint32_t number(string_view s) {
+        const auto [it, added] =
+            numbers.emplace(s, uint32_t(stringAt.size() - 1));
+        if (added) {
+            if (stringAt.size() > UINT32_MAX)
+                throw Exception("Too many strings for a dictionary file");
+            text += s;
+            stringAt.push_back(text.size());
+        }
+        return it->second;
+    }
+
+    FormList list(const vector<string> &forms) {
+        if (listed.size() + forms.size() > UINT32_MAX)
+            throw Exception("Too many forms for a dictionary file");
+        FormList list;
+        list.begin = uint32_t(listed.size());
+        list.count = uint32_t(forms.size());
+        for (const string &form : forms)
+            listed.push_back(number(form));
+        return list;
+    }
+
+    // The strings are views of the entries, so they must outlive the builder
+    template <typename R, typename E>
+    vector<R> records(const vector<E> &entries) {
+        vector<R> records(entries.size());
+        for (size_t i = 0; i < entries.size(); i++) {
+            R &record = records[i];
+            eachList(entries[i], record,
+                     [&](const vector<string> &forms, FormList &list) {
+                         list = this->list(forms);
+                     });
+            copyFields(entries[i], record);
+        }
+        return records;
+    }
+};
+
+template <typename T> static string_view bytesOf(const vector<T> &v) {
+    return string_view(reinterpret_cast<const char *>(v.data()),
+                       v.size() * sizeof(T));
+}
+
+// Tells if the entries and the map saved with them are of the same file
+static uint64_t fingerprint(const string_view *sections, size_t count) {
+    uint64_t hash = 14695981039346656037u;
+    for (size_t s = 0; s < count; s++) {
+        const string_view bytes = sections[s];
+        size_t i = 0;
+        for (; i + 8 <= bytes.size(); i += 8) {
+            uint64_t word;
+            std::memcpy(&word, bytes.data() + i, sizeof(word));
+            hash = (hash ^ word) * 1099511628211u;
+            hash ^= hash >> 29;
+        }
+        for (; i < bytes.size(); i++)
+            hash = (hash ^ uint8_t(bytes[i])) * 1099511628211u;
+        hash = (hash ^ bytes.size()) * 1099511628211u;
+    }
+    return hash;
+}
+
+// The number of an entry a Word of the map points to
+static uint32_t entryOf(const Word &word, const Dictionary &dict) {
+    size_t entry = 0, count = 0;
+    switch (word.w) {
+    case WordType::Noun:
+        entry = word.noun - dict.nouns.data();
+        count = dict.nouns.size();
+        break;
+    case WordType::Verb:
+        entry = word.verb - dict.verbs.data();
+        count = dict.verbs.size();
+        break;
+    case WordType::Adjective:
+        entry = word.adj - dict.adjectives.data();
+        count = dict.adjectives.size();
+        break;
+    case WordType::Adverb:
+        entry = word.adv - dict.adverbs.data();
+        count = dict.adverbs.size();
+        break;
+    case WordType::Pronoun:
+        entry = word.pro - dict.pronouns.data();
+        count = dict.pronouns.size();
+        break;
+    default:
+        break;
+    }
+    if (entry >= count)
+        throw Exception("The map of the dictionary isn't of its entries");
+    return uint32_t(entry);
+}
+
+void writeDictionaryFile(const string &path, const Dictionary &dict,
+                         bool lookup) {
+    DictionaryBuilder builder;
+    const vector<NounRecord> nouns =
+        builder.records<NounRecord>(dict.nouns);
+    const vector<VerbRecord> verbs =
+        builder.records<VerbRecord>(dict.verbs);
+    const vector<AdjectiveRecord> adjectives =
+        builder.records<AdjectiveRecord>(dict.adjectives);
+    const vector<AdverbRecord> adverbs =
+        builder.records<AdverbRecord>(dict.adverbs);
+    const vector<PronounRecord> pronouns =
+        builder.records<PronounRecord>(dict.pronouns);
+
+    vector<LookupKey> keys;
+    vector<LookupWord> words;
+    if (lookup) {
+        const map<string, vector<Word>> &built = dict.formMap();
+        if (built.empty() &&
+            !(dict.nouns.empty() && dict.verbs.empty() &&
+              dict.adjectives.empty() && dict.adverbs.empty() &&
+              dict.pronouns.empty()))
+            throw Exception("The map of the dictionary isn't built");
+        keys.reserve(built.size() + 1);
+        for (const auto &[key, found] : built) {
+            keys.push_back({builder.number(key), uint32_t(words.size())});
+            for (const Word &word : found)
+                words.push_back({uint32_t(word.w), entryOf(word, dict)});
+        }
+        keys.push_back({0, uint32_t(words.size())});
+    }
+
+    vector<std::pair<DictionarySection, string_view>> sections = {
+        {DictionarySection::stringOffsets, bytesOf(builder.stringAt)},
+        {DictionarySection::text, builder.text},
+        {DictionarySection::lists, bytesOf(builder.listed)},
+        {DictionarySection::nouns, bytesOf(nouns)},
+        {DictionarySection::verbs, bytesOf(verbs)},
+        {DictionarySection::adjectives, bytesOf(adjectives)},
+        {DictionarySection::adverbs, bytesOf(adverbs)},
+        {DictionarySection::pronouns, bytesOf(pronouns)}};
+    // The keys were added to the strings, so these are their final bytes
+    vector<uint64_t> check;
+    if (lookup) {
+        string_view entries[size_t(DictionarySection::pronouns) + 1];
+        for (size_t i = 0; i < sections.size(); i++)
+            entries[i] = sections[i].second;
+        check = {fingerprint(entries, sections.size()), nouns.size(),
+                 verbs.size(), adjectives.size(), adverbs.size(),
+                 pronouns.size()};
+        sections.push_back({DictionarySection::lookupKeys, bytesOf(keys)});
+        sections.push_back({DictionarySection::lookupWords, bytesOf(words)});
+        sections.push_back({DictionarySection::lookupCheck, bytesOf(check)});
+    }
+    const size_t count = sections.size();
+
+    writeBinaryFile(path, magic, [&](ostream &out) {
+        writeBinary(out, uint64_t(count));
+        uint64_t at = sizeof(magic) + (1 + 3 * count) * sizeof(uint64_t);
+        for (const auto &[kind, bytes] : sections) {
+            writeBinary(out, uint64_t(kind));
+            writeBinary(out, at);
+            writeBinary(out, uint64_t(bytes.size()));
+            at += (bytes.size() + 7) / 8 * 8;
+        }
+        for (const auto &section : sections) {
+            const string_view bytes = section.second;
+            out.write(bytes.data(), bytes.size());
+            for (size_t i = bytes.size(); i % 8 != 0; i++)
+                out.put('\0');
+        }
+    });
+}
+
+DictionaryFile::DictionaryFile(const string &path) : path(path), file(path) {
+    const char *data = file.data();
+    const size_t size = file.size();
+    const size_t headerSize = sizeof(magic) + sizeof(uint64_t);
+    if (size < headerSize + sizeof(binaryEndMark) ||
+        !std::equal(magic, magic + sizeof(magic), data))
+        throw Exception(path + " is of another kind or version");
+    const size_t end = size - sizeof(binaryEndMark);
+    if (!std::equal(binaryEndMark, binaryEndMark + sizeof(binaryEndMark),
+                    data + end))
+        throw Exception(path + " is truncated");
+
+    // The mapping starts on a page, so the aligned sections can be used
+    // where they are
+    const uint64_t *header =
+        reinterpret_cast<const uint64_t *>(data + sizeof(magic));
+    const uint64_t count = header[0];
+    if (count > (end - headerSize) / (3 * sizeof(uint64_t)))
+        throw Exception(path + " has a broken section table");
+    const uint64_t *table = header + 1;
+    const size_t tableEnd = headerSize + count * 3 * sizeof(uint64_t);
+
+    bool has[kinds] = {};
+    for (size_t i = 0; i < count; i++) {
+        const uint64_t kind = table[3 * i];
+        const uint64_t offset = table[3 * i + 1];
+        const uint64_t bytes = table[3 * i + 2];
+        if (offset % 8 != 0 || offset < tableEnd || offset > end ||
+            bytes > end - offset)
+            throw Exception(path + " has a broken section table");
+        if (kind < kinds) {
+            sections[kind] = string_view(data + offset, bytes);
+            has[kind] = true;
+        }
+    }
+    for (size_t kind = 0; kind <= size_t(DictionarySection::pronouns);
+         kind++) {
+        if (!has[kind])
+            throw Exception(path + " lacks a section");
+    }
+
+    auto section = [&](DictionarySection kind, size_t unit) {
+        const string_view bytes = sections[size_t(kind)];
+        if (bytes.size() % unit != 0)
+            throw Exception(path + " has a broken section");
+        return std::make_pair(bytes.data(), bytes.size() / unit);
+    };
+    const auto offsets =
+        section(DictionarySection::stringOffsets, sizeof(uint64_t));
+    const string_view text = sections[size_t(DictionarySection::text)];
+    stringAt = reinterpret_cast<const uint64_t *>(offsets.first);
+    chars = text.data();
+    if (offsets.second == 0 || stringAt[0] != 0 ||
+        stringAt[offsets.second - 1] != text.size())
+        throw Exception(path + " has broken strings");
+    strings = offsets.second - 1;
+    for (size_t i = 0; i < strings; i++) {
+        if (stringAt[i] > stringAt[i + 1])
+            throw Exception(path + " has broken strings");
+    }
+
+    const auto lists = section(DictionarySection::lists, sizeof(uint32_t));
+    listed = reinterpret_cast<const uint32_t *>(lists.first);
+    this->lists = lists.second;
+
+    auto records = [&](auto &into, DictionarySection kind) {
+        typedef std::decay_t<decltype(*into.begin())> R;
+        const auto bytes = section(kind, sizeof(R));
+        into = Records<R>(reinterpret_cast<const R *>(bytes.first),
+                          bytes.second);
+    };
+    records(nounRecords, DictionarySection::nouns);
+    records(verbRecords, DictionarySection::verbs);
+    records(adjectiveRecords, DictionarySection::adjectives);
+    records(adverbRecords, DictionarySection::adverbs);
+    records(pronounRecords, DictionarySection::pronouns);
+}
+
+// Checks that the lists of the records and the string numbers in them are in
+// the file. blank only tells eachList the word class.
+template <typename R, typename E>
+static bool fits(const DictionaryFile::Records<R> &records, const E &blank,
+                 const uint32_t *listed, size_t lists, size_t strings) {
+    bool fit = true;
+    for (R record : records) {
+        eachList(blank, record, [&](const auto &, const FormList &list) {
+            if (uint64_t(list.begin) + list.count > lists) {
+                fit = false;
+                return;
+            }
+            for (size_t i = list.begin; i < list.begin + list.count; i++)
+                fit &= listed[i] < strings;
+        });
+        if (!fit)
+            return false;
+    }
+    return true;
+}
+
+void DictionaryFile::check(WordType type) const {
+    bool fit = false;
+    switch (type) {
+    case WordType::Noun:
+        fit = fits(nounRecords, Noun(), listed, lists, strings);
+        break;
+    case WordType::Verb:
+        fit = fits(verbRecords, Verb(), listed, lists, strings);
+        break;
+    case WordType::Adjective:
+        fit = fits(adjectiveRecords, Adjective(), listed, lists, strings);
+        break;
+    case WordType::Adverb:
+        fit = fits(adverbRecords, Adverb(), listed, lists, strings);
+        break;
+    case WordType::Pronoun:
+        fit = fits(pronounRecords, Pronoun(), listed, lists, strings);
+        break;
+    default:
+        throw Exception("Not a word class of the dictionary file");
+    }
+    if (!fit)
+        throw Exception(path + " has broken entries");
+}
+
+void DictionaryFile::checked(WordType type) const {
+    // A check that throws is tried again the next time
+    std::call_once(checks[size_t(type)], [&]() { check(type); });
+}
+
+template <typename E, typename R>
+static void loadRecords(const DictionaryFile &file,
+                        const DictionaryFile::Records<R> &records,
+                        vector<E> &entries) {
+    entries.reserve(entries.size() + records.size());
+    for (R record : records) {
+        E &entry = entries.emplace_back();
+        eachList(entry, record, [&](vector<string> &forms, FormList &list) {
+            forms.reserve(list.count);
+            for (const string_view form : file.forms(list))
+                forms.emplace_back(form);
+        });
+        copyFields(record, entry);
+    }
+}
+
+void DictionaryFile::load(Dictionary &dict,
+                          std::initializer_list<WordType> classes) const {
+    for (const WordType type : classes) {
+        switch (type) {
+        case WordType::Noun:
+            loadRecords(*this, nouns(), dict.nouns);
+            break;
+        case WordType::Verb:
+            loadRecords(*this, verbs(), dict.verbs);
+            break;
+        case WordType::Adjective:
+            loadRecords(*this, adjectives(), dict.adjectives);
+            break;
+        case WordType::Adverb:
+            loadRecords(*this, adverbs(), dict.adverbs);
+            break;
+        case WordType::Pronoun:
+            loadRecords(*this, pronouns(), dict.pronouns);
+            break;
+        default:
+            throw Exception("Not a word class of the dictionary file");
+        }
+    }
+}
+
+bool DictionaryFile::hasLookup() const {
+    return !sections[size_t(DictionarySection::lookupCheck)].empty();
+}
+
+void DictionaryFile::loadWithLookup(Dictionary &dict) const {
+    if (!(dict.nouns.empty() && dict.verbs.empty() &&
+          dict.adjectives.empty() && dict.adverbs.empty() &&
+          dict.pronouns.empty()))
+        throw Exception("The saved map needs an empty dictionary");
+    if (!hasLookup())
+        throw Exception(path + " has no saved map");
+
+    // Everything is checked before the entries are loaded
+    const string_view checkBytes =
+        sections[size_t(DictionarySection::lookupCheck)];
+    const string_view keyBytes =
+        sections[size_t(DictionarySection::lookupKeys)];
+    const string_view wordBytes =
+        sections[size_t(DictionarySection::lookupWords)];
+    const size_t counts[] = {nounRecords.size(), verbRecords.size(),
+                             adjectiveRecords.size(), adverbRecords.size(),
+                             pronounRecords.size()};
+    const size_t classes = sizeof(counts) / sizeof(counts[0]);
+    if (checkBytes.size() != (1 + classes) * sizeof(uint64_t) ||
+        keyBytes.size() % sizeof(LookupKey) != 0 || keyBytes.empty() ||
+        wordBytes.size() % sizeof(LookupWord) != 0)
+        throw Exception(path + " has a broken map");
+    const uint64_t *check =
+        reinterpret_cast<const uint64_t *>(checkBytes.data());
+    if (check[0] !=
+        fingerprint(sections, size_t(DictionarySection::pronouns) + 1))
+        throw Exception(path + " has a map of other entries");
+    for (size_t c = 0; c < classes; c++) {
+        if (check[1 + c] != counts[c])
+            throw Exception(path + " has a map of other entries");
+    }
+
+    const LookupKey *keys =
+        reinterpret_cast<const LookupKey *>(keyBytes.data());
+    const size_t keyCount = keyBytes.size() / sizeof(LookupKey) - 1;
+    const LookupWord *words =
+        reinterpret_cast<const LookupWord *>(wordBytes.data());
+    const size_t wordCount = wordBytes.size() / sizeof(LookupWord);
+    if (keys[0].firstWord != 0 || keys[keyCount].firstWord != wordCount)
+        throw Exception(path + " has a broken map");
+    for (size_t k = 0; k < keyCount; k++) {
+        if (keys[k].key >= strings ||
+            keys[k].firstWord > keys[k + 1].firstWord ||
+            (k > 0 && text(keys[k - 1].key) >= text(keys[k].key)))
+            throw Exception(path + " has a broken map");
+    }
+    for (size_t w = 0; w < wordCount; w++) {
+        if (words[w].type >= classes ||
+            words[w].entry >= counts[words[w].type])
+            throw Exception(path + " has a broken map");
+    }
+
+    load(dict);
+    // The keys are in order, so every one goes to the end of the map
+    map<string, vector<Word>> built;
+    for (size_t k = 0; k < keyCount; k++) {
+        vector<Word> &found =
+            built.emplace_hint(built.end(), text(keys[k].key), vector<Word>())
+                ->second;
+        found.reserve(keys[k + 1].firstWord - keys[k].firstWord);
+        for (size_t w = keys[k].firstWord; w < keys[k + 1].firstWord; w++) {
+            Word word;
+            word.w = WordType(words[w].type);
+            const uint32_t entry = words[w].entry;
+            switch (word.w) {
+            case WordType::Noun:
+                word.noun = &dict.nouns[entry];
+                break;
+            case WordType::Verb:
+                word.verb = &dict.verbs[entry];
+                break;
+            case WordType::Adjective:
+                word.adj = &dict.adjectives[entry];
+                break;
+            case WordType::Adverb:
+                word.adv = &dict.adverbs[entry];
+                break;
+            default:
+                word.pro = &dict.pronouns[entry];
+            }
+            found.push_back(word);
+        }
+    }
+    dict.adoptMap(std::move(built));
+}
+
+} // namespace parseWiki
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+using std::string, std::string_view;
+
+#include "dictionary.hpp"
+#include "mappedFile.hpp"
+
+namespace parseWiki {
+
+// The dictionary in a binary file that is meant to be mapped, so that it can
+// be used without parsing it or copying its strings:
+//
+//   magic with the version, number of sections          8 bytes each
+//   the section table: kind, offset and size of every section
+//   the sections, every one aligned to 8 bytes
+//   end mark
+//
+// Every string is stored once in the text, however many entries have it, and
+// is found by its number through the string offsets. The lists section has
+// the string numbers of all lists of forms, and the entries are records of a
+// fixed size per word class that say where their lists are. The map of
+// Dictionary::buildMap can be saved too, as its keys in order and the entries
+// of every key. Sections of kinds a reader doesn't know are skipped. The
+// numbers are as in memory, like the files of binaryIO.hpp.
+
+enum class DictionarySection : uint64_t {
+    stringOffsets, // Where every string starts in the text, then its end
+    text,
+    lists, // uint32_t string numbers
+    nouns,
+    verbs,
+    adjectives,
+    adverbs,
+    pronouns,
+    lookupKeys,  // LookupKey of every key of the map, then one for the end
+    lookupWords, // LookupWord of every entry of every key
+    lookupCheck, // Fingerprint of the sections above, then the record counts
+};
+
+// Some of the string numbers in the lists section
+struct FormList {
+    uint32_t begin = 0, count = 0;
+};
+
+// The lists of cases are by case and then singular and plural
+struct NounRecord {
+    FormList cases[4][2];
+    uint8_t type;  // NounType
+    uint8_t genus; // 1 masculine, 2 neuter, 4 feminine
+    uint8_t noSingular, noPlural;
+};
+
+struct VerbRecord {
+    FormList presentInfinitive;
+    FormList present[3][2]; // By person, then singular and plural
+    FormList participleII;
+    FormList subjunctive_firstSingular;
+    FormList irrealis_firstSingular;
+    FormList preterite_firstSingular;
+    FormList auxiliary;
+    FormList imperative[2];
+};
+
+struct AdjectiveRecord {
+    FormList positive, comparative, superlative;
+    FormList cases[9][4][2]; // As in Adjective
+};
+
+struct AdverbRecord {
+    FormList positive, comparative, superlative;
+    uint32_t type; // AdverbType
+};
+
+struct PronounRecord {
+    uint32_t type; // pronounType
+    FormList cases[4][2];
+};
+
+struct LookupKey {
+    uint32_t key;       // String number
+    uint32_t firstWord; // In the lookupWords section
+};
+
+struct LookupWord {
+    uint32_t type; // WordType
+    uint32_t entry;
+};
+
+// Writes dict to a dictionary file next to path and moves it over path when
+// done. With lookup, the map of dict.buildMap() is saved as well, so it must
+// have been built.
+void writeDictionaryFile(const string &path, const Dictionary &dict,
+                         bool lookup = false);
+
+// A mapped dictionary file. Opening it only checks that its tables fit
+// together; the entries are read from the mapping where they are. The records
+// of a word class are checked when they are first asked for, so the pages of
+// the others aren't touched.
+class DictionaryFile {
+  public:
+    template <typename T> class Records {
+      private:
+        const T *first = nullptr;
+        size_t count = 0;
+
+      public:
+        Records() = default;
+        Records(const T *first, size_t count) : first(first), count(count) {}
+
+        size_t size() const { return count; }
+        const T &operator[](size_t i) const { return first[i]; }
+        const T *begin() const { return first; }
+        const T *end() const { return first + count; }
+    };
+
+    // The strings of a FormList
+    class Forms {
+      private:
+        const DictionaryFile *file;
+        const uint32_t *first;
+        size_t count;
+
+      public:
+        Forms(const DictionaryFile *file, const uint32_t *first, size_t count)
+            : file(file), first(first), count(count) {}
+
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        string_view operator[](size_t i) const {
+            return file->text(first[i]);
+        }
+
+        class iterator {
+          private:
+            const DictionaryFile *file;
+            const uint32_t *at;
+
+          public:
+            iterator(const DictionaryFile *file, const uint32_t *at)
+                : file(file), at(at) {}
+            string_view operator*() const { return file->text(*at); }
+            iterator &operator++() {
+                ++at;
+                return *this;
+            }
+            bool operator!=(const iterator &other) const {
+                return at != other.at;
+            }
+        };
+        iterator begin() const { return iterator(file, first); }
+        iterator end() const { return iterator(file, first + count); }
+    };
+
+  private:
+    static const size_t kinds = size_t(DictionarySection::lookupCheck) + 1;
+
+    string path;
+    MappedFile file;
+    string_view sections[kinds]; // Empty if missing
+    const uint64_t *stringAt = nullptr;
+    size_t strings = 0;
+    const char *chars = nullptr;
+    const uint32_t *listed = nullptr;
+    size_t lists = 0;
+    Records<NounRecord> nounRecords;
+    Records<VerbRecord> verbRecords;
+    Records<AdjectiveRecord> adjectiveRecords;
+    Records<AdverbRecord> adverbRecords;
+    Records<PronounRecord> pronounRecords;
+    mutable std::once_flag checks[5]; // By WordType
+
+    void check(WordType type) const;
+    void checked(WordType type) const;
+
+  public:
+    // Throws an Exception if the file is missing, of another version or
+    // corrupt
+    explicit DictionaryFile(const string &path);
+
+    string_view text(uint32_t string) const {
+        return string_view(chars + stringAt[string],
+                           stringAt[string + 1] - stringAt[string]);
+    }
+    Forms forms(const FormList &list) const {
+        return Forms(this, listed + list.begin, list.count);
+    }
+
+    // These throw an Exception if the records are corrupt
+    const Records<NounRecord> &nouns() const {
+        checked(WordType::Noun);
+        return nounRecords;
+    }
+    const Records<VerbRecord> &verbs() const {
+        checked(WordType::Verb);
+        return verbRecords;
+    }
+    const Records<AdjectiveRecord> &adjectives() const {
+        checked(WordType::Adjective);
+        return adjectiveRecords;
+    }
+    const Records<AdverbRecord> &adverbs() const {
+        checked(WordType::Adverb);
+        return adverbRecords;
+    }
+    const Records<PronounRecord> &pronouns() const {
+        checked(WordType::Pronoun);
+        return pronounRecords;
+    }
+
+    // Copies the entries of the given word classes into dict, behind the ones
+    // it has. The time and memory it takes are those of these classes only.
+    void load(Dictionary &dict,
+              std::initializer_list<WordType> classes = {
+                  WordType::Noun, WordType::Verb, WordType::Adjective,
+                  WordType::Adverb, WordType::Pronoun}) const;
+
+    // Whether the map of buildMap was saved
+    bool hasLookup() const;
+
+    // Loads all entries into dict, which must be empty, and gives it the
+    // saved map instead of building it. Throws an Exception if there is none
+    // or it doesn't belong to the entries of the file.
+    void loadWithLookup(Dictionary &dict) const;
+};
+
+} // namespace parseWiki
@@ -0,0 +1,176 @@
+#include "dictionaryReader.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <system_error>
+
+#include "mappedFile.hpp"
+#include "util.hpp"
+
+namespace parseWiki {
+
+// The whitespace of the "C" locale, which the streams of Dictionary use
+static bool isSpace(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+DictionaryReader::DictionaryReader(string_view text, const string &name,
+                                   size_t from, size_t to)
+    : text(text), at(std::min(from, text.size())),
+      end(std::min(to, text.size())), name(name) {
+    if (at > end)
+        at = end;
+}
+
+Exception DictionaryReader::error(const char *what) const {
+    const size_t line = std::count(text.begin(), text.begin() + at, '\n') + 1;
+    const size_t start =
+        at == 0 ? string_view::npos : text.rfind('\n', at - 1);
+    const size_t column = start == string_view::npos ? at + 1 : at - start;
+    return Exception(name + ", line " + std::to_string(line) + ", column " +
+                     std::to_string(column) + ": " + what);
+}
+
+void DictionaryReader::skipSpace() {
+    while (at < end && isSpace(text[at]))
+        at++;
+}
+
+// Like operator>> of a stream: whitespace, maybe a sign, then the digits
+template <typename T> T DictionaryReader::number(const char *what) {
+    skipSpace();
+    const char *first = text.data() + at;
+    const char *last = text.data() + end;
+    if (last - first > 1 && *first == '+' && first[1] >= '0' &&
+        first[1] <= '9')
+        first++;
+    T value = 0;
+    const auto [stop, result] = std::from_chars(first, last, value);
+    if (result != std::errc())
+        throw error(what);
+    at = stop - text.data();
+    return value;
+}
+
+bool DictionaryReader::flag() {
+    skipSpace();
+    const size_t start = at;
+    const unsigned value = number<unsigned>("expected 0 or 1");
+    if (value > 1) {
+        at = start;
+        throw error("expected 0 or 1");
+    }
+    return value == 1;
+}
+
+size_t DictionaryReader::size() {
+    skipSpace();
+    const size_t start = at;
+    const size_t value = number<size_t>("expected the size of a list");
+    // Every element takes a byte at least
+    if (value > 1024 * 1024 * 1024 || value > end - at) {
+        at = start;
+        throw error("the size of the list is too large");
+    }
+    return value;
+}
+
+void DictionaryReader::get(vector<string> &v) {
+    v.clear();
+    v.resize(size());
+    for (string &s : v) {
+        const size_t length = number<size_t>("expected the length of a form");
+        // One character after the length is skipped, whatever it is
+        if (length >= end - at)
+            throw error("the form is longer than the rest of the file");
+        s.assign(text.data() + at + 1, length);
+        at += length + 1;
+    }
+}
+
+void DictionaryReader::get(Numeri &n) {
+    get(n.singular);
+    get(n.plural);
+}
+
+void DictionaryReader::get(Genus &g) {
+    g.m = flag();
+    g.n = flag();
+    g.f = flag();
+}
+
+void DictionaryReader::get(Person &p) {
+    get(p.first);
+    get(p.second);
+    get(p.third);
+}
+
+void DictionaryReader::get(WithCases &c) {
+    for (size_t i = 0; i < 4; i++)
+        get(c.cases[i]);
+}
+
+template <typename T> void DictionaryReader::getEntries(vector<T> &v) {
+    v.clear();
+    v.resize(size());
+    for (T &entry : v)
+        read(entry);
+}
+
+void DictionaryReader::read(Dictionary &dict) {
+    getEntries(dict.nouns);
+    getEntries(dict.verbs);
+    getEntries(dict.adjectives);
+    getEntries(dict.adverbs);
+    getEntries(dict.pronouns);
+}
+
+void DictionaryReader::read(Noun &n) {
+    get(static_cast<WithCases &>(n));
+    get(n.genus);
+    n.noSingular = flag();
+    n.noPlural = flag();
+    n.type = (NounType)number<int>("expected the type of a noun");
+}
+
+// In the order of Verb::deserialize, which reads the irrealis twice
+void DictionaryReader::read(Verb &v) {
+    get(v.base.presentInfinitive);
+    get(v.base.participleII);
+    get(v.base.irrealis_firstSingular);
+    get(v.base.irrealis_firstSingular);
+    get(v.base.preterite_firstSingular);
+    get(v.base.auxiliary);
+    get(v.base.present);
+    get(v.imperative);
+}
+
+void DictionaryReader::read(Adjective &a) {
+    get(a.positive);
+    get(a.comparative);
+    get(a.superlative);
+    for (size_t i = 0; i < 9; i++)
+        get(a.cases[i]);
+}
+
+void DictionaryReader::read(Adverb &a) {
+    get(a.positive);
+    get(a.comparative);
+    get(a.superlative);
+    a.type = (AdverbType)number<int>("expected the type of an adverb");
+}
+
+void DictionaryReader::read(Pronoun &p) {
+    p.type = (pronounType)number<int>("expected the type of a pronoun");
+    get(static_cast<WithCases &>(p));
+}
+
+bool DictionaryReader::atEnd() {
+    skipSpace();
+    return at == end;
+}
+
+void readDictionaryText(const string &path, Dictionary &dict) {
+    MappedFile file(path);
+    DictionaryReader(file.view(), path).read(dict);
+}
+
+} // namespace parseWiki
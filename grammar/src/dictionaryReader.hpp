@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+using std::string, std::string_view;
+
+#include "dictionary.hpp"
+
+namespace parseWiki {
+
+// Reads the text format of Dictionary::serialize from memory. It accepts the
+// same files as Dictionary::deserialize, but without a stream: numbers are
+// read with std::from_chars and whitespace is skipped by hand. Errors are
+// thrown as an Exception that tells the line and column they are at, which
+// are only counted then.
+class DictionaryReader {
+  private:
+    string_view text;
+    size_t at, end;
+    string name; // Of the file, for the errors
+
+    Exception error(const char *what) const;
+    void skipSpace();
+    template <typename T> T number(const char *what);
+    bool flag();
+    size_t size(); // Of a vector, checked for sanity
+
+    void get(vector<string> &v);
+    void get(Numeri &n);
+    void get(Genus &g);
+    void get(Person &p);
+    void get(WithCases &c);
+    template <typename T> void getEntries(vector<T> &v);
+
+  public:
+    // Reads text from the offset from to the offset to. The line and column
+    // of errors are counted from the start of text.
+    DictionaryReader(string_view text, const string &name, size_t from = 0,
+                     size_t to = string_view::npos);
+
+    void read(Dictionary &dict);
+    void read(Noun &n);
+    void read(Verb &v);
+    void read(Adjective &a);
+    void read(Adverb &a);
+    void read(Pronoun &p);
+
+    // The number of entries of a word class that comes next
+    size_t readSize() { return size(); }
+
+    // Whether only whitespace is left
+    bool atEnd();
+};
+
+// Maps the file at path and reads it like Dictionary::deserialize
+void readDictionaryText(const string &path, Dictionary &dict);
+
+} // namespace parseWiki
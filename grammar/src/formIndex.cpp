@@ -0,0 +1,65 @@
+#include "formIndex.hpp"
+
+#include <iterator>
+
+namespace parseWiki {
+
+static void moveForms(vector<InflectedForm> &to,
+                      vector<InflectedForm> &from) {
+    to.insert(to.end(), std::make_move_iterator(from.begin()),
+              std::make_move_iterator(from.end()));
+    from.clear();
+}
+
+void FormIndex::append(FormIndex &&other) {
+    moveForms(nouns, other.nouns);
+    moveForms(verbs, other.verbs);
+    moveForms(adjectives, other.adjectives);
+    moveForms(pronouns, other.pronouns);
+}
+
+vector<string> &verbSlot(Verb &v, size_t slot) {
+    switch (slot) {
+    case 0:
+        return v.base.present.first.singular;
+    case 1:
+        return v.base.present.second.singular;
+    case 2:
+        return v.base.present.third.singular;
+    case 3:
+        return v.base.present.first.plural;
+    case 4:
+        return v.base.present.second.plural;
+    case 5:
+        return v.base.present.third.plural;
+    case 6:
+        return v.base.preterite_firstSingular;
+    case 7:
+        return v.base.subjunctive_firstSingular;
+    case 8:
+        return v.base.irrealis_firstSingular;
+    case 9:
+        return v.base.participleII;
+    case 10:
+        return v.base.presentInfinitive;
+    case 11:
+        return v.imperative.singular;
+    case 12:
+        return v.imperative.plural;
+    default:
+        throw Exception("No verb slot " + std::to_string(slot));
+    }
+}
+
+size_t verbSlotOf(const Verbspec &spec) {
+    // Let set pick the place, so the two can't disagree
+    Verb probe;
+    if (!probe.set(spec, string()))
+        return verbSlots;
+    for (size_t slot = 0; slot < verbSlots; slot++)
+        if (!verbSlot(probe, slot).empty())
+            return slot;
+    return verbSlots;
+}
+
+} // namespace parseWiki
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+using std::string;
+using std::vector;
+
+#include "dictionary.hpp"
+
+namespace parseWiki {
+
+// A form from a "Deklinierte Form" or "Konjugierte Form" page: the form, the
+// lemma it belongs to and which forms of the lemma it is. It only exists to be
+// merged into the entry of the lemma, so it is kept instead of an entry with
+// nothing but these.
+struct InflectedForm {
+    string form;
+    string lemma;
+    // Bits of the forms it is. Nouns and pronouns: 2 * case + plural.
+    // Adjectives: the same plus 8 * genus (masculine, feminine, neuter). Verbs:
+    // the slots of verbSlot.
+    uint32_t slots = 0;
+    uint8_t detail = 0;      // pronounType of pronouns, degree of adjectives
+    bool formIsKey = false;  // Merged by the form too, not only by the lemma
+};
+
+// The bit of the nominative singular of nouns and pronouns
+static const uint32_t nominativeSingular = 1;
+
+// The inflected forms by the word class of their lemma, in the order of the
+// dump
+struct FormIndex {
+    vector<InflectedForm> nouns, verbs, adjectives, pronouns;
+
+    void append(FormIndex &&other);
+};
+
+// The forms of a verb an inflected form can be, in the order of the bits
+static const size_t verbSlots = 13;
+vector<string> &verbSlot(Verb &v, size_t slot);
+
+// The slot Verb::set puts a form of spec in, verbSlots if there is none
+size_t verbSlotOf(const Verbspec &spec);
+
+} // namespace parseWiki
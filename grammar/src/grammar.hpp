@@ -177,6 +177,10 @@ struct WithCases {
         for (size_t i = 0; i < 4; i++)
             cases[i] = cp.cases[i];
     }
+    void move(WithCases &mv) {
+        for (size_t i = 0; i < 4; i++)
+            cases[i] = std::move(mv.cases[i]);
+    }
 
   public:
     WithCases()
@@ -186,11 +190,16 @@ struct WithCases {
           accusative(cases[(size_t)Cases::Accusative]) {}
 
     WithCases(const WithCases &cp) : WithCases() { copy(cp); }
+    WithCases(WithCases &&mv) noexcept : WithCases() { move(mv); }
 
     WithCases &operator=(const WithCases &A) {
         copy(A);
         return *this;
     }
+    WithCases &operator=(WithCases &&A) noexcept {
+        move(A);
+        return *this;
+    }
 
     Numeri cases[4];
     Numeri &nominative, &genitive, &dative, &accusative;
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+using std::string_view;
+
+#include "util.hpp"
+
+namespace parseWiki {
+
+template <typename V> struct Keyword {
+    string_view key;
+    V value;
+};
+
+constexpr uint32_t keywordHash(string_view key, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ (seed * 0x9e3779b9u);
+    for (const char c : key) {
+        hash ^= uint8_t(c);
+        hash *= 16777619u;
+    }
+    return hash ^ (hash >> 15);
+}
+
+constexpr size_t keywordSlots(size_t n) {
+    size_t slots = 1;
+    while (slots < n)
+        slots *= 2;
+    return slots;
+}
+
+// Looks up a fixed set of keywords with two hashes of the key and one
+// comparison. Built at compile time by hash and displace: a first hash spreads
+// the keywords over buckets, and every bucket gets the seed of a second hash
+// that puts each of its keywords into a slot of its own. A constexpr table that
+// can't be built, for example because a keyword is listed twice, doesn't
+// compile.
+template <typename V, size_t N> class KeywordTable {
+  private:
+    static constexpr size_t slots = keywordSlots(2 * N);
+    static constexpr size_t buckets = keywordSlots(N / 4 + 1);
+
+    Keyword<V> table[slots] = {};
+    bool used[slots] = {};
+    uint32_t seeds[buckets] = {};
+
+    constexpr bool place(const Keyword<V> *words, const size_t *bucket,
+                         size_t b, uint32_t seed) {
+        size_t placed[N] = {};
+        size_t count = 0;
+        for (size_t i = 0; i < N; i++) {
+            if (bucket[i] != b)
+                continue;
+            const size_t slot = keywordHash(words[i].key, seed) % slots;
+            if (used[slot]) {
+                for (size_t j = 0; j < count; j++)
+                    used[placed[j]] = false;
+                return false;
+            }
+            used[slot] = true;
+            table[slot] = words[i];
+            placed[count++] = slot;
+        }
+        return true;
+    }
+
+  public:
+    constexpr explicit KeywordTable(const Keyword<V> *words) {
+        size_t bucket[N] = {};
+        size_t sizes[buckets] = {};
+        for (size_t i = 0; i < N; i++) {
+            for (size_t j = 0; j < i; j++) {
+                if (words[i].key == words[j].key)
+                    throw Exception("Keyword listed twice");
+            }
+            bucket[i] = keywordHash(words[i].key, 0) % buckets;
+            sizes[bucket[i]]++;
+        }
+        // The biggest buckets first, while most slots are free
+        for (size_t size = N; size > 0; size--) {
+            for (size_t b = 0; b < buckets; b++) {
+                if (sizes[b] != size)
+                    continue;
+                uint32_t seed = 1;
+                while (!place(words, bucket, b, seed)) {
+                    if (++seed == 1u << 16)
+                        throw Exception("No perfect hash for the keywords");
+                }
+                seeds[b] = seed;
+            }
+        }
+    }
+
+    // The value of key, nullptr if it isn't one of the keywords
+    constexpr const V *find(string_view key) const {
+        const size_t b = keywordHash(key, 0) % buckets;
+        const size_t slot = keywordHash(key, seeds[b]) % slots;
+        if (used[slot] && table[slot].key == key)
+            return &table[slot].value;
+        return nullptr;
+    }
+};
+
+template <typename V, size_t N>
+constexpr KeywordTable<V, N> keywordTable(const Keyword<V> (&words)[N]) {
+    return KeywordTable<V, N>(words);
+}
+
+constexpr string_view keyOf(string_view key) { return key; }
+template <typename V> constexpr string_view keyOf(const Keyword<V> &keyword) {
+    return keyword.key;
+}
+
+// The index of the first of keys that text contains, K if there is none. The
+// same as checking them in order with has().
+template <typename T, size_t K>
+constexpr size_t firstContained(string_view text, const T (&keys)[K]) {
+    for (size_t i = 0; i < K; i++) {
+        if (text.find(keyOf(keys[i])) != string_view::npos)
+            return i;
+    }
+    return K;
+}
+
+// A table of the usual names that has what firstContained would find in them,
+// so that it's only searched for in the others
+template <typename T, size_t N, typename U, size_t K>
+constexpr KeywordTable<size_t, N> containedKeywords(const T (&names)[N],
+                                                    const U (&keys)[K]) {
+    std::array<Keyword<size_t>, N> words = {};
+    for (size_t i = 0; i < N; i++)
+        words[i] = {keyOf(names[i]), firstContained(keyOf(names[i]), keys)};
+    return KeywordTable<size_t, N>(words.data());
+}
+
+// A table of the index of every keyword
+template <typename V, size_t N>
+constexpr KeywordTable<size_t, N> indexKeywords(const Keyword<V> (&keys)[N]) {
+    std::array<Keyword<size_t>, N> words = {};
+    for (size_t i = 0; i < N; i++)
+        words[i] = {keys[i].key, i};
+    return KeywordTable<size_t, N>(words.data());
+}
+
+} // namespace parseWiki
@@ -9,12 +9,19 @@ using std::make_shared, std::shared_ptr;
 using std::string, std::vector;
 
 //#include "find.hpp"
+#include "chunkIndex.hpp"
+#include "diagnostics.hpp"
 #include "dictionary.hpp"
+#include "dictionaryFile.hpp"
+#include "dictionaryReader.hpp"
 #include "filters.hpp"
 #include "grammarIO.hpp"
 #include "kompositum.hpp"
+#include "mappedFile.hpp"
 #include "parseWiki.hpp"
 #include "punctuation.hpp"
+#include "stats.hpp"
+#include "syntheticDump.hpp"
 #include "util.hpp"
 
 typedef int Finder;
@@ -270,13 +277,37 @@ int main(int argc, char **argv) {
 
     try {
 
+        ///////////////////////// Benchmark on synthetic dumps
+#if 0
+        parseWiki::benchmarkParse(cout, {10000, 100000, 1000000}, "dict");
+        return 0;
+#endif
+
         ///////////////////////// Re-Create DB
 #if 1
         cout << "Analyze..." << endl;
+        parseWiki::Checkpointing checkpoints;
+        checkpoints.path = "dict/parseWiki.checkpoint";
         Dictionary dict = parseWiki::parseWiki(
-            shared_ptr<istream>(std::make_shared<std::ifstream>(
-                //"dict/test.dict")));
-                "dict/dewiktionary-20190201-pages-articles-multistream.xml")));
+            "dict/dewiktionary-20190201-pages-articles-multistream.xml.bz2",
+            "dict/"
+            "dewiktionary-20190201-pages-articles-multistream-index.txt.bz2",
+            0, parseWiki::PageFilter(), checkpoints, "dict/pages.bin");
+        // Dictionary dict = parseWiki::parseWiki(shared_ptr<istream>(
+        //    std::make_shared<std::ifstream>("dict/test.dict")));
+        // Or with bounded memory, straight into db.txt:
+        // parseWiki::Spilling spilling;
+        // spilling.dir = "dict/spill";
+        // std::ofstream out("dict/db.txt", std::ios::binary);
+        // parseWiki::parseWiki(out, "dict/...multistream.xml.bz2",
+        //                      "dict/...multistream-index.txt.bz2", 0,
+        //                      parseWiki::PageFilter(), checkpoints, spilling);
+        // Or in two phases, to parse the extracted sections again after every
+        // change to the grammar rules:
+        // parseWiki::extractSections("dict/...multistream.xml.bz2",
+        //                            "dict/...multistream-index.txt.bz2",
+        //                            "dict/sections.bin");
+        // Dictionary dict = parseWiki::parseSections("dict/sections.bin");
 
         cout << dict << endl;
         std::ofstream fo("dict/db.txt", std::ios::binary);
@@ -285,32 +316,72 @@ int main(int argc, char **argv) {
             return -1;
         }
         cout << "Simplify..." << endl;
-        dict.simplify();
+        {
+            const parseWiki::StageTimer timer(parseWiki::Stage::simplify);
+            dict.simplify();
+        }
         cout << "Serialize..." << endl;
-        dict.serialize(fo);
-        fo.close();
+        {
+            const parseWiki::StageTimer timer(parseWiki::Stage::serialize);
+            // The same as dict.serialize(fo), with an index for reading
+            // db.txt on all cores
+            parseWiki::serializeChunked(fo, dict, "dict/db.txt.chunks");
+            fo.close();
+        }
+        {
+            const parseWiki::StageTimer timer(parseWiki::Stage::buildMap);
+            dict.buildMap();
+        }
+        {
+            // With the lookup map, so loading it needs no buildMap
+            const parseWiki::StageTimer timer(parseWiki::Stage::serialize);
+            parseWiki::writeDictionaryFile("dict/db.bin", dict, true);
+        }
+        parseWiki::stats().report(cout, dict);
+        diagnostics().summary(cout);
         cout << "Done." << endl;
         return 1;
 #endif
 
         ///////////////////////// Load DB
 
-        std::ifstream fi("dict/db.txt", std::ios::binary);
-        LineNumberStreambuf lb(fi);
-        if (!fi.good()) {
-            std::cerr << "BAD FILE" << endl;
-            return -1;
-        }
+        // The mapped binary file with the saved map if there is one, so the
+        // map isn't built again. Lookups that only need the forms can use
+        // file.nouns() and the others directly. A file of an older version
+        // or a damaged one is skipped for db.txt.
         Dictionary d2;
-        try {
-            d2.deserialize(fi);
-            cout << endl << endl << d2 << endl;
-        } catch (std::exception &e) {
-            cout << endl << "Error: " << e.what() << endl;
-            cout << " at line " << lb.lineNumber() << " " << fi.good() << endl;
+        std::unique_ptr<parseWiki::DictionaryFile> file;
+        bool loaded = false;
+        if (std::ifstream("dict/db.bin", std::ios::binary).good()) {
+            try {
+                file =
+                    std::make_unique<parseWiki::DictionaryFile>("dict/db.bin");
+                if (file->hasLookup()) {
+                    file->loadWithLookup(d2);
+                    loaded = true;
+                }
+            } catch (Exception &e) {
+                cout << endl
+                     << "Reading dict/db.txt instead: " << e.what() << endl;
+                file.reset();
+                d2 = Dictionary();
+            }
         }
-
-        d2.buildMap();
+        if (!loaded) {
+            parseWiki::MappedFile db("dict/db.txt");
+            try {
+                // The error tells the line and column
+                parseWiki::DictionaryReader(db.view(), "dict/db.txt")
+                    .read(d2);
+            } catch (Exception &e) {
+                cout << endl << "Error: " << e.what() << endl;
+            }
+            // Or in parallel with the chunk index:
+            // parseWiki::deserializeChunked("dict/db.txt",
+            //                               "dict/db.txt.chunks", d2);
+            d2.buildMap();
+        }
+        cout << endl << endl << d2 << endl;
 
         ///////////////////////////// Test Nouns
 #if 0
@@ -349,6 +420,7 @@ int main(int argc, char **argv) {
         }
 #endif
 
+        diagnostics().summary(cout);
         cout << endl << "done" << endl;
         return 0;
 
@@ -0,0 +1,87 @@
+#include "mappedFile.hpp"
+
+#include "util.hpp"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace parseWiki {
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const string &path) {
+    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                       OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        file = nullptr;
+        throw Exception("Can't open " + path);
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw Exception("Can't open " + path);
+    }
+    length = size_t(size.QuadPart);
+    // Empty files can't be mapped
+    if (length == 0)
+        return;
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping)
+        begin = static_cast<const char *>(
+            MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!begin) {
+        if (mapping)
+            CloseHandle(mapping);
+        CloseHandle(file);
+        throw Exception("Can't map " + path);
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (begin)
+        UnmapViewOfFile(begin);
+    if (mapping)
+        CloseHandle(mapping);
+    if (file)
+        CloseHandle(file);
+}
+
+#else
+
+MappedFile::MappedFile(const string &path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw Exception("Can't open " + path);
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw Exception("Can't open " + path);
+    }
+    length = size_t(info.st_size);
+    if (length > 0) {
+        void *mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            close(fd);
+            throw Exception("Can't map " + path);
+        }
+        begin = static_cast<const char *>(mapped);
+    }
+    // The mapping stays valid without the descriptor
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (begin)
+        munmap(const_cast<char *>(begin), length);
+}
+
+#endif
+
+} // namespace parseWiki
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+using std::string, std::string_view;
+
+namespace parseWiki {
+
+// A file mapped into memory for reading. The pages are loaded by the system
+// when they are first touched and can be dropped again when memory is short.
+class MappedFile {
+  private:
+    const char *begin = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void *file = nullptr;
+    void *mapping = nullptr;
+#endif
+
+  public:
+    // Throws an Exception if the file can't be opened or mapped
+    explicit MappedFile(const string &path);
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const char *data() const { return begin; }
+    size_t size() const { return length; }
+    string_view view() const { return string_view(begin, length); }
+};
+
+} // namespace parseWiki
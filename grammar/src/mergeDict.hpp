@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+using std::string;
+using std::vector;
+
+#include "dictionary.hpp"
+#include "formIndex.hpp"
+#include "threadPool.hpp"
+
+namespace parseWiki {
+
+// The forms an entry is merged by. Entries that share none of them are never
+// merged, and merging only adds forms of the merged entry.
+const vector<string> &mergeKey(const Noun &n);
+const vector<string> &mergeKey(const Adjective &a);
+const vector<string> &mergeKey(const Pronoun &p);
+const vector<string> &mergeKey(const Verb &v);
+
+// Adds every form of from to the first entry of into that fits it, in order.
+// Forms that fit none are dropped. Counts the forms tried and merged.
+void mergeForms(vector<Noun> &into, const vector<InflectedForm> &from,
+                size_t &merged, size_t &tryMerge);
+void mergeForms(vector<Adjective> &into, const vector<InflectedForm> &from,
+                size_t &merged, size_t &tryMerge);
+void mergeForms(vector<Pronoun> &into, const vector<InflectedForm> &from,
+                size_t &merged, size_t &tryMerge);
+void mergeForms(vector<Verb> &into, const vector<InflectedForm> &from,
+                size_t &merged, size_t &tryMerge);
+
+// Adds the forms of "Deklinierte Form" and "Konjugierte Form" pages to the
+// entries of dict
+void mergeDict(Dictionary &dict, const FormIndex &forms, ThreadPool &pool);
+
+} // namespace parseWiki
@@ -0,0 +1,185 @@
+#include "multistream.hpp"
+
+#include <bzlib.h>
+
+#include <algorithm>
+#include <sstream>
+
+#include "util.hpp"
+
+namespace parseWiki {
+
+string decompressBz2(const string &in) {
+    string out;
+    char buf[64 * 1024];
+    bz_stream strm = {};
+    strm.next_in = const_cast<char *>(in.data());
+    strm.avail_in = (unsigned int)in.size();
+
+    while (strm.avail_in > 0) {
+        if (BZ2_bzDecompressInit(&strm, 0, 0) != BZ_OK)
+            throw Exception("bz2: init failed");
+        int ret;
+        do {
+            strm.next_out = buf;
+            strm.avail_out = sizeof(buf);
+            ret = BZ2_bzDecompress(&strm);
+            if ((ret != BZ_OK && ret != BZ_STREAM_END) ||
+                (ret == BZ_OK && strm.avail_in == 0 && strm.avail_out != 0)) {
+                BZ2_bzDecompressEnd(&strm);
+                throw Exception("bz2: corrupt or truncated stream");
+            }
+            out.append(buf, sizeof(buf) - strm.avail_out);
+        } while (ret != BZ_STREAM_END);
+        BZ2_bzDecompressEnd(&strm);
+    }
+    return out;
+}
+
+MultistreamBuf::MultistreamBuf(const string &path, const string &indexPath,
+                               size_t threads, const ResumePoint &from)
+    : file(path, std::ios::binary), nextRead(0), nextOut(0),
+      maxAhead(4 * std::max<size_t>(threads, 1)),
+      skip(from.offset - from.streamStart), position(from.streamStart),
+      stop(false) {
+    if (!file.good())
+        throw Exception("Can't open " + path);
+    readOffsets(indexPath);
+
+    if (from.offset < from.streamStart)
+        throw Exception("Invalid resume point");
+    auto it = std::lower_bound(offsets.begin(), offsets.end() - 1, from.stream);
+    if (it == offsets.end() - 1 || *it != from.stream)
+        throw Exception("Resume point doesn't match " + indexPath);
+    nextRead = nextOut = it - offsets.begin();
+    file.seekg(from.stream);
+    for (size_t i = 0; i < std::max<size_t>(threads, 1); i++)
+        workers.emplace_back([this]() { work(); });
+}
+
+MultistreamBuf::~MultistreamBuf() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    changed.notify_all();
+    for (auto &worker : workers)
+        worker.join();
+}
+
+void MultistreamBuf::readOffsets(const string &indexPath) {
+    std::ifstream fi(indexPath, std::ios::binary);
+    if (!fi.good())
+        throw Exception("Can't open " + indexPath);
+    std::stringstream index;
+    index << fi.rdbuf();
+
+    // The siteinfo in front of the first page is a stream of its own, just
+    // like the closing tag behind the last one
+    offsets.push_back(0);
+    std::istringstream lines(decompressBz2(index.str()));
+    string line;
+    while (std::getline(lines, line)) {
+        if (line.empty())
+            continue;
+        const size_t offset = std::stoull(line.substr(0, line.find(':')));
+        if (offset > offsets.back())
+            offsets.push_back(offset);
+    }
+
+    file.seekg(0, std::ios::end);
+    const size_t size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    if (size < offsets.back())
+        throw Exception("Index doesn't match " + indexPath);
+    offsets.push_back(size);
+}
+
+void MultistreamBuf::work() {
+    while (true) {
+        std::pair<size_t, string> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&]() { return !compressed.empty() || stop; });
+            if (stop)
+                return;
+            job = std::move(compressed.front());
+            compressed.pop_front();
+        }
+        string out;
+        std::exception_ptr failed;
+        try {
+            out = decompressBz2(job.second);
+        } catch (...) {
+            failed = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (failed && !error)
+                error = failed;
+            decompressed.emplace(job.first, std::move(out));
+        }
+        changed.notify_all();
+    }
+}
+
+bool MultistreamBuf::nextChunk() {
+    const size_t streams = offsets.size() - 1;
+    while (nextOut < streams) {
+        // Read ahead, the workers decompress while we wait for the next one
+        while (nextRead < streams && nextRead - nextOut < maxAhead) {
+            string data(offsets[nextRead + 1] - offsets[nextRead], '\0');
+            if (!file.read(&data[0], data.size()))
+                throw Exception("Unexpected end of the dump");
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                compressed.emplace_back(nextRead++, std::move(data));
+            }
+            changed.notify_all();
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&]() { return decompressed.count(nextOut) > 0; });
+        if (error)
+            std::rethrow_exception(error);
+        auto it = decompressed.find(nextOut);
+        current = std::move(it->second);
+        decompressed.erase(it);
+        handedOut.emplace_back(position, nextOut++);
+        position += current.size();
+        if (skip >= current.size()) {
+            skip -= current.size();
+            continue;
+        }
+        return true;
+    }
+    return false;
+}
+
+int MultistreamBuf::underflow() {
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+    if (!nextChunk())
+        return traits_type::eof();
+    setg(&current[0], &current[0] + skip, &current[0] + current.size());
+    skip = 0;
+    return traits_type::to_int_type(*gptr());
+}
+
+ResumePoint MultistreamBuf::locate(size_t offset) {
+    std::lock_guard<std::mutex> lock(mutex);
+    // The last stream that starts at or in front of offset
+    auto it = std::upper_bound(
+        handedOut.begin(), handedOut.end(), offset,
+        [](size_t o, const std::pair<size_t, size_t> &h) { return o < h.first; });
+    if (it == handedOut.begin() || offset > position)
+        throw Exception("Can't locate offset " + std::to_string(offset));
+    --it;
+    ResumePoint at;
+    at.offset = offset;
+    at.stream = offsets[it->second];
+    at.streamStart = it->first;
+    return at;
+}
+
+} // namespace parseWiki
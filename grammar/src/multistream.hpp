@@ -0,0 +1,90 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <istream>
+#include <map>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+using std::istream;
+using std::map;
+using std::string;
+using std::vector;
+
+#include "wikiReader.hpp"
+
+namespace parseWiki {
+
+// Decompresses a bz2 stream. Concatenated streams are decompressed one after
+// another.
+string decompressBz2(const string &compressed);
+
+// Serves the decompressed content of a bz2 "multistream" dump in order, while
+// a pool of threads decompresses the streams ahead. The stream boundaries are
+// taken from the (bz2 compressed) index that comes with the dump. Its lines
+// look like offset:pageId:title.
+class MultistreamBuf : public std::streambuf {
+  private:
+    std::ifstream file;
+    vector<size_t> offsets; // Begin of every stream and the end of the file
+    size_t nextRead, nextOut;
+    const size_t maxAhead;
+    string current;
+    size_t skip; // Bytes to drop from the next non-empty stream
+
+    // Decompressed offset and index of every stream handed out so far
+    vector<std::pair<size_t, size_t>> handedOut;
+    size_t position; // Decompressed offset behind the last one
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::pair<size_t, string>> compressed;
+    map<size_t, string> decompressed;
+    std::exception_ptr error;
+    bool stop;
+    vector<std::thread> workers;
+
+    void readOffsets(const string &indexPath);
+    void work();
+    bool nextChunk();
+
+  protected:
+    int underflow() override;
+
+  public:
+    // Starts reading at from, which has to come from locate
+    MultistreamBuf(const string &path, const string &indexPath,
+                   size_t threads, const ResumePoint &from = ResumePoint());
+    ~MultistreamBuf();
+
+    // Where to continue for reading from the given decompressed offset on.
+    // Works for every offset up to what has been read.
+    ResumePoint locate(size_t offset);
+
+    // Size of the dump file
+    size_t dumpSize() const { return offsets.back(); }
+};
+
+// Errors of the decompression are rethrown by the reading functions
+class MultistreamIn : public istream {
+  private:
+    MultistreamBuf buf;
+
+  public:
+    MultistreamIn(const string &path, const string &indexPath, size_t threads,
+                  const ResumePoint &from = ResumePoint())
+        : istream(nullptr), buf(path, indexPath, threads, from) {
+        rdbuf(&buf);
+        exceptions(std::ios::badbit);
+    }
+
+    ResumePoint locate(size_t offset) { return buf.locate(offset); }
+    size_t dumpSize() const { return buf.dumpSize(); }
+};
+
+} // namespace parseWiki
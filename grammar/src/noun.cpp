@@ -1,10 +1,10 @@
 #include "noun.hpp"
+#include "diagnostics.hpp"
 #include "dictionary.hpp"
 #include "grammarIO.hpp"
 #include "kompositum.hpp"
 
-#include <iostream>
-using std::cout, std::endl;
+#include <sstream>
 
 string Noun::np(const Dictionary &dict, bool forceArtificial) const {
     if (noPlural)
@@ -43,14 +43,12 @@ string Noun::ns() const {
         return "";
     if (nominative.singular.empty()) {
         if (nominative.plural.empty()) {
-            cout << endl << "Error: nominative!" << endl;
-            cout << *this << endl;
+            std::ostringstream noun;
+            noun << *this;
+            diagnose(Problem::noNominative, noun.str());
             throw Exception("nominative needed!");
         } else {
-            cout << endl
-                 << "Error: Singular doesn't exist! "
-                 << (nominative.plural.empty() ? "" : nominative.plural[0])
-                 << endl;
+            diagnose(Problem::noSingular, nominative.plural[0]);
             return "";
         }
     }
@@ -0,0 +1,21 @@
+#include "pageArena.hpp"
+
+namespace parseWiki {
+
+static thread_local std::pmr::memory_resource *current = nullptr;
+
+PageArena::PageArena(size_t initialSize)
+    : initial(initialSize),
+      resource(initial.data(), initial.size(),
+               std::pmr::new_delete_resource()),
+      previous(current) {
+    current = &resource;
+}
+
+PageArena::~PageArena() { current = previous; }
+
+std::pmr::memory_resource *scratch() {
+    return current ? current : std::pmr::new_delete_resource();
+}
+
+} // namespace parseWiki
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace parseWiki {
+
+// Memory for everything that only lives while one page is parsed: the parts
+// the wiki text is split into, section titles and the like. Allocating is
+// bumping a pointer, freeing is a no-op and reset drops the whole page at
+// once. Only what goes into the dictionary is allocated the usual way.
+//
+// An arena is installed for the thread that creates it, scratch() hands it
+// out to the parse functions until it is destroyed.
+class PageArena {
+  private:
+    std::vector<std::byte> initial;
+    std::pmr::monotonic_buffer_resource resource;
+    std::pmr::memory_resource *previous;
+
+  public:
+    explicit PageArena(size_t initialSize = 1024 * 1024);
+    ~PageArena();
+    PageArena(const PageArena &) = delete;
+    PageArena &operator=(const PageArena &) = delete;
+
+    // Forget everything allocated since the last reset. Memory beyond the
+    // initial block is given back, the initial block is kept for the next page.
+    void reset() { resource.release(); }
+};
+
+// The arena of the calling thread or the heap if there is none
+std::pmr::memory_resource *scratch();
+
+} // namespace parseWiki
@@ -0,0 +1,144 @@
+#include "pageStore.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+#include "binaryIO.hpp"
+
+namespace parseWiki {
+
+static const char magic[8] = {'P', 'W', 'P', 'A', 'G', 'E', '0', '2'};
+
+static void countEntries(const Dictionary &dict, const FormIndex &forms,
+                         size_t (&counts)[9]) {
+    counts[0] = dict.nouns.size();
+    counts[1] = dict.verbs.size();
+    counts[2] = dict.adjectives.size();
+    counts[3] = dict.adverbs.size();
+    counts[4] = dict.pronouns.size();
+    counts[5] = forms.nouns.size();
+    counts[6] = forms.verbs.size();
+    counts[7] = forms.adjectives.size();
+    counts[8] = forms.pronouns.size();
+}
+
+void PageRecord::begin(const Dictionary &dict, const FormIndex &forms) {
+    countEntries(dict, forms, entries);
+}
+
+void PageRecord::end(const Dictionary &dict, const FormIndex &forms) {
+    size_t now[9];
+    countEntries(dict, forms, now);
+    for (size_t i = 0; i < 9; i++)
+        entries[i] = now[i] - entries[i];
+}
+
+void PageShard::append(PageShard &&other) {
+    dict.append(std::move(other.dict));
+    forms.append(std::move(other.forms));
+    for (const auto &wc : other.wordClasses)
+        wordClasses[wc.first] += wc.second;
+    records.insert(records.end(), std::make_move_iterator(other.records.begin()),
+                   std::make_move_iterator(other.records.end()));
+    other.records.clear();
+    pages += other.pages;
+    end = other.end;
+}
+
+bool PageStore::load(const string &path) {
+    const bool found = readBinaryFile(path, magic, [&](istream &in) {
+        readRecords(in, records);
+        readBinary(in, dict);
+        readBinary(in, forms);
+    });
+    if (!found)
+        return false;
+
+    size_t next[9] = {};
+    starts.resize(records.size() * 9);
+    for (size_t r = 0; r < records.size(); r++) {
+        for (size_t i = 0; i < 9; i++) {
+            starts[r * 9 + i] = next[i];
+            next[i] += records[r].entries[i];
+        }
+        if (records[r].id != 0)
+            byId.emplace(records[r].id, r);
+    }
+    size_t total[9];
+    countEntries(dict, forms, total);
+    if (!std::equal(next, next + 9, total))
+        throw Exception(path + " is corrupt");
+    return true;
+}
+
+size_t PageStore::unchanged(uint64_t id, uint64_t revision) const {
+    if (id == 0 || revision == 0)
+        return npos;
+    auto it = byId.find(id);
+    if (it == byId.end() || records[it->second].revision != revision)
+        return npos;
+    return it->second;
+}
+
+template <typename T>
+static void copyRange(const vector<T> &from, size_t start, size_t count,
+                      vector<T> &to) {
+    to.insert(to.end(), from.begin() + start, from.begin() + start + count);
+}
+
+void PageStore::copyTo(size_t record, PageShard &shard) const {
+    const PageRecord &r = records[record];
+    const size_t *at = &starts[record * 9];
+    copyRange(dict.nouns, at[0], r.entries[0], shard.dict.nouns);
+    copyRange(dict.verbs, at[1], r.entries[1], shard.dict.verbs);
+    copyRange(dict.adjectives, at[2], r.entries[2], shard.dict.adjectives);
+    copyRange(dict.adverbs, at[3], r.entries[3], shard.dict.adverbs);
+    copyRange(dict.pronouns, at[4], r.entries[4], shard.dict.pronouns);
+    copyRange(forms.nouns, at[5], r.entries[5], shard.forms.nouns);
+    copyRange(forms.verbs, at[6], r.entries[6], shard.forms.verbs);
+    copyRange(forms.adjectives, at[7], r.entries[7], shard.forms.adjectives);
+    copyRange(forms.pronouns, at[8], r.entries[8], shard.forms.pronouns);
+    for (const auto &wc : r.wordClasses)
+        shard.wordClasses[wc.first] += wc.second;
+    shard.records.push_back(r);
+}
+
+void writeRecords(ostream &out, const vector<PageRecord> &records) {
+    writeBinary(out, records.size());
+    for (const PageRecord &r : records) {
+        writeBinary(out, r.id);
+        writeBinary(out, r.revision);
+        for (size_t i = 0; i < 9; i++)
+            writeBinary(out, r.entries[i]);
+        writeBinary(out, r.wordClasses.size());
+        for (const auto &wc : r.wordClasses) {
+            writeBinary(out, wc.first);
+            writeBinary(out, wc.second);
+        }
+    }
+}
+
+void readRecords(istream &in, vector<PageRecord> &records) {
+    records.resize(readSize(in));
+    for (PageRecord &r : records) {
+        r.id = readNumber(in);
+        r.revision = readNumber(in);
+        for (size_t i = 0; i < 9; i++)
+            r.entries[i] = readNumber(in);
+        r.wordClasses.resize(readSize(in));
+        for (auto &wc : r.wordClasses) {
+            readBinary(in, wc.first);
+            wc.second = readNumber(in);
+        }
+    }
+}
+
+void savePages(const string &path, const PageShard &all) {
+    writeBinaryFile(path, magic, [&](ostream &out) {
+        writeRecords(out, all.records);
+        writeBinary(out, all.dict);
+        writeBinary(out, all.forms);
+    });
+}
+
+} // namespace parseWiki
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+using std::map;
+using std::pair;
+using std::string;
+using std::vector;
+
+#include "dictionary.hpp"
+#include "formIndex.hpp"
+
+namespace parseWiki {
+
+// What one page contributed to dict and forms. The entries of the pages
+// follow each other in the order of the dump.
+struct PageRecord {
+    uint64_t id = 0, revision = 0; // 0 if the page didn't tell
+    // Nouns, verbs, adjectives, adverbs and pronouns of dict, then nouns,
+    // verbs, adjectives and pronouns of forms
+    size_t entries[9] = {};
+    vector<pair<string, size_t>> wordClasses;
+
+    // Counts the entries while the page is parsed
+    void begin(const Dictionary &dict, const FormIndex &forms);
+    void end(const Dictionary &dict, const FormIndex &forms);
+};
+
+// Everything parsed from a contiguous run of pages
+struct PageShard {
+    Dictionary dict;
+    FormIndex forms;
+    map<string, size_t> wordClasses;
+    vector<PageRecord> records; // Only if they are kept
+    size_t pages = 0; // Pages read, including the skipped ones
+    size_t end = 0;   // Input offset behind the last of them
+
+    void append(PageShard &&other);
+};
+
+// The pages of an earlier run with their entries, so unchanged pages of a
+// newer dump don't have to be parsed again. The entries are the ones before
+// mergeDict, which can't be undone.
+class PageStore {
+  private:
+    Dictionary dict;
+    FormIndex forms;
+    vector<PageRecord> records;
+    vector<size_t> starts; // Of every record's entries, 9 per record
+    std::unordered_map<uint64_t, size_t> byId;
+
+  public:
+    // Returns false if there is no file at path
+    bool load(const string &path);
+
+    // Index of the record if the page is known in the same revision or npos
+    size_t unchanged(uint64_t id, uint64_t revision) const;
+
+    // Appends a copy of the record's entries. Safe to call from several
+    // threads.
+    void copyTo(size_t record, PageShard &shard) const;
+
+    static const size_t npos = size_t(-1);
+};
+
+// Writes the records with the entries of all pages for the next run
+void savePages(const string &path, const PageShard &all);
+
+// The records alone, in the format of binaryIO.hpp
+void writeRecords(std::ostream &out, const vector<PageRecord> &records);
+void readRecords(std::istream &in, vector<PageRecord> &records);
+
+} // namespace parseWiki
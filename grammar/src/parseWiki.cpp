@@ -1,165 +1,149 @@
 #include "parseWiki.hpp"
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <fstream>
 #include <iostream>
 #include <istream>
+#include <iterator>
 #include <memory>
+#include <mutex>
 #include <ostream>
-#include <regex>
-#include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 using std::cout, std::cin, std::endl;
 using std::istream, std::ostream;
 using std::shared_ptr, std::make_shared;
-using std::string;
+using std::string, std::string_view;
 using std::tuple, std::get;
 using std::vector;
 
+#include "checkpoint.hpp"
+#include "diagnostics.hpp"
+#include "formIndex.hpp"
 #include "grammar.hpp"
+#include "keywords.hpp"
+#include "mergeDict.hpp"
+#include "multistream.hpp"
+#include "pageArena.hpp"
+#include "pageStore.hpp"
 #include "pronoun.hpp"
+#include "sectionFile.hpp"
+#include "spill.hpp"
+#include "stats.hpp"
+#include "threadPool.hpp"
 #include "util.hpp"
+#include "wikiReader.hpp"
+#include "wikiScanner.hpp"
 
 using namespace parseWiki;
 
-// If the string looks like something empty, delete it
-string saniWiki(const string &cstr) {
-    string str;
-    str.reserve(cstr.size());
-    for (size_t i = 0; i < cstr.size(); i++) {
-        if (cstr[i] == '&') {
-            // Ampersand will usually start some HTML-Comment but if it
-            // is the &-HTML-Entity, keep it and proceed
-            if (cstr.size() - i > 5) {
-                if (cstr.substr(i, 5) == "&amp;") {
-                    i += 4;
-                    str.push_back('&');
-                    continue;
-                }
+// If the string looks like something empty, delete it. The only place where the
+// views into the page become strings of their own, so the result is the only
+// allocation unless the value has an &amp;.
+string saniWiki(const string_view &cstr) {
+    // Ampersand will usually start some HTML-Comment but if it is the
+    // &-HTML-Entity, keep it and proceed
+    const auto entity = [&](size_t i) {
+        return cstr.size() - i > 5 && cstr.compare(i, 5, "&amp;") == 0;
+    };
+    string_view text = cstr.substr(0, cstr.find('&'));
+    std::pmr::string decoded(scratch());
+    if (text.size() < cstr.size() && entity(text.size())) {
+        decoded.reserve(cstr.size());
+        for (size_t i = 0; i < cstr.size(); i++) {
+            if (cstr[i] != '&') {
+                decoded.push_back(cstr[i]);
+            } else if (entity(i)) {
+                decoded.push_back('&');
+                i += 4;
+            } else {
+                break;
             }
-            break;
         }
-        str.push_back(cstr[i]);
+        text = decoded;
     }
-    str = trim(str);
-    if (str == "-" || str == "0" || str == "—" || str == "?")
+    const string_view trimmed = trim(text);
+    if (trimmed == "-" || trimmed == "0" || trimmed == "—" || trimmed == "?")
         return "";
 
-    replaceHere(str, "’", "'");
-    str = removeSub(str, "·");
-    fixUTF8(str);
-    trimHere(str);
-
-    if (str.length() > 100)
-        return ""; // invalid
-
-    return str;
-}
-
-string readUntil(shared_ptr<istream> &in, const string &ref) {
-    string content = "";
-    string buf = "";
-    for (size_t i = 0; i < ref.size(); i++)
-        buf += "\n";
-    while (true) {
-        if (buf == ref)
+    // Replace ’ by ' and drop ·, a · that is only formed by dropping another
+    // one is dropped as well. Both aren't ASCII, so runs of ASCII are copied
+    // as they are.
+    string out;
+    out.reserve(trimmed.size());
+    bool ascii = true;
+    for (size_t i = 0; i < trimmed.size();) {
+        const size_t run = asciiPrefix(trimmed.substr(i));
+        out.append(trimmed.data() + i, run);
+        i += run;
+        if (i == trimmed.size())
             break;
-        for (size_t i = 1; i < buf.size(); i++)
-            buf[i - 1] = buf[i];
-        char n;
-        if (!in->get(n))
-            return "\0";
-        buf[buf.size() - 1] = n;
-        content += n;
-    }
-    return content;
-}
-
-string readTag(shared_ptr<istream> &in, const string &tag) {
-    if (readUntil(in, "<" + tag + ">") == "\0")
-        return "\0";
-    const string content = readUntil(in, "</" + tag + ">");
-    if (content.length() < (tag.length() + 3))
-        return "\0";
-    return content.substr(0, content.length() - tag.length() - 3);
-}
-
-string readTag(const string &container, const string &tag) {
-    shared_ptr<istream> is(make_shared<std::istringstream>(container));
-    return readTag(is, tag);
-}
-
-template <size_t which> string match(const string &text, const std::regex &re) {
-
-    std::sregex_iterator next(text.begin(), text.end(), re,
-                              std::regex_constants::match_any |
-                                  std::regex_constants::match_not_null);
-    std::sregex_iterator end;
-    while (next != end) {
-        std::smatch match = *next;
-        for (size_t i = 0; i < match.size(); ++i) {
-            if (i == which)
-                return match[i];
+        if (trimmed.compare(i, 3, "’") == 0) {
+            out.push_back('\'');
+            i += 3;
+        } else if (trimmed[i] == '\xB7' && !out.empty() &&
+                   out.back() == '\xC2') {
+            out.pop_back();
+            i++;
+        } else {
+            out.push_back(trimmed[i]);
+            ascii = false;
+            i++;
         }
-        next++;
     }
+    if (!ascii)
+        fixUTF8(out);
+    trimHere(out);
 
-    return "";
-}
-
-template <size_t which>
-vector<string> all(const string &text, const std::regex &re) {
-    vector<string> results;
-    std::sregex_iterator next(text.begin(), text.end(), re,
-                              std::regex_constants::match_any |
-                                  std::regex_constants::match_not_null);
-    std::sregex_iterator end;
-    while (next != end) {
-        std::smatch match = *next;
-        for (size_t i = 0; i < match.size(); ++i) {
-            if (i == which) {
-                results.push_back(match[i]);
-                break;
-            }
-        }
-        next++;
-    }
+    if (out.length() > 100)
+        return ""; // invalid
 
-    return results;
+    return out;
 }
 
-vector<tuple<string, string>> parseInnerPar(const string &text) {
-    vector<tuple<string, string>> res;
+std::pmr::vector<tuple<string_view, string_view>>
+parseInnerPar(const string_view &text) {
+    std::pmr::vector<tuple<string_view, string_view>> res(scratch());
+    if (text.size() < 2)
+        return res;
     bool lastWasNewLineOrFirst = true;
     for (size_t i = 0; i < text.size() - 1; i++) {
         if (lastWasNewLineOrFirst) {
             if (text[i] == '{' && text[i + 1] == '{') {
-                string match;
-                match.reserve(512);
+                const size_t matchStart = i + 2;
                 for (i += 2; i < text.size() - 1; i++) {
                     if (text[i] == '}' && text[i + 1] == '}')
                         break;
-                    match.push_back(text[i]);
                 }
-                match.shrink_to_fit();
-                string contentA;
-                contentA.reserve(512);
+                const string_view match =
+                    text.substr(matchStart, i - matchStart);
+                string_view contentA;
                 if (text.size() > i + 4) {
                     i += 2;
                     if (text[i] == '\n' &&
                         (text[i + 1] == ':' || text[i + 1] == '\n' ||
                          text[i + 1] == '*')) {
+                        const size_t contentStart = i + 2;
+                        size_t contentEnd = contentStart;
                         for (i += 2; i < text.size() - 2; i++) {
-                            contentA.push_back(text[i]);
+                            contentEnd = i + 1;
                             if (text[i] == '\n' && text[i + 1] == '{' &&
                                 text[i + 2] == '{')
                                 break;
                         }
+                        contentA = text.substr(contentStart,
+                                               contentEnd - contentStart);
                     }
                 }
-                contentA.shrink_to_fit();
-                res.push_back(tuple(match, contentA));
+                res.emplace_back(match, contentA);
             }
         }
         if (text[i] == '\n')
@@ -170,169 +154,232 @@ vector<tuple<string, string>> parseInnerPar(const string &text) {
     return res;
 }
 
-template <size_t which>
-vector<tuple<string, string>> leading(const string &text, const std::regex &re,
-                                      const bool includeFirst = false) {
-    vector<tuple<string, string>> results;
-    std::sregex_iterator next(text.begin(), text.end(), re,
-                              std::regex_constants::match_any |
-                                  std::regex_constants::match_not_null);
-    std::sregex_iterator end;
-
-    if (includeFirst) {
-        string content;
-        if (next != end) {
-            std::smatch nextMatch = *next;
-            auto f = nextMatch[0].first;
-            content = string(text.begin(), f);
-        } else
-            content = text;
-        results.push_back(tuple("", content));
-    }
-
-    while (next != end) {
-        std::smatch match = *next;
-        bool needsInc = true;
-        string matches;
-        for (size_t i = 0; i < match.size(); ++i) {
-            if (i == which) {
-                matches = match[i];
-                break;
-            }
-        }
-
-        next++;
-        if (match.size() > 0) {
-            string content = "";
-            if (next != end) {
-                auto s = match[0].second;
-                std::smatch nextMatch = *next;
-                auto f = nextMatch[0].first;
-                content = string(s, f);
-            } else {
-                auto s = match[0].second;
-                content = string(s, text.end());
-            }
-            results.push_back(tuple(matches, trim(content)));
-            continue;
-        }
-    }
-
-    return results;
+std::pmr::vector<string_view> parseSectionTitle(const string_view &title) {
+    std::pmr::vector<string_view> parts(scratch());
+    for (const Part &x : leading(title, Literal("}}, {{"), true))
+        parts.push_back(trim(get<1>(x)));
+    return parts;
 }
 
-template <size_t which>
-vector<tuple<string, string>> tailing(const string &text,
-                                      const std::regex &re) {
-    vector<tuple<string, string>> results;
-    std::sregex_iterator next(text.begin(), text.end(), re,
-                              std::regex_constants::match_any |
-                                  std::regex_constants::match_not_null);
-    std::sregex_iterator end;
-
-    auto prev = text.begin();
-
-    while (next != end) {
-        std::smatch match = *next;
-        bool needsInc = true;
-        string matches;
-        for (size_t i = 0; i < match.size(); ++i) {
-            if (i == which) {
-                matches = match[i];
-                break;
-            }
-        }
-
-        next++;
-        if (match.size() > 0) {
-            string content = "";
-
-            auto s = match[0].first;
-            content = string(prev, s);
-            prev = match[0].second;
-
-            results.push_back(tuple(matches, trim(content)));
-            continue;
+// How a table of forms takes a parameter, looked up by its name without the
+// numbering
+enum class ParamKind : uint8_t {
+    forms,   // Numbered, after any whitespace
+    bare,    // Numbered, after no space
+    persons, // With up to three stars, right after the name
+    genus,
+};
+
+struct Param {
+    ParamKind kind;
+    uint8_t target; // Which forms, depends on the table
+};
+
+// A template parameter split into its name and the numbering after it:
+// "Nominativ Singular 2*=x" has the name "Nominativ Singular", a space as gap,
+// the number 2 and one star
+struct ParamName {
+    string_view name;
+    string_view value;
+    string_view gap; // Whitespace between the name and the numbering
+    size_t stars = 0;
+    char number = 0;
+    bool spaceAfterNumber = false; // "2 ="
+    bool strength = false;         // stark, schwach or gemischt
+};
+
+// Splits prop backwards from the first "=". False if there is none.
+static bool splitParam(const string_view &prop, ParamName &p) {
+    const size_t equals = prop.find('=');
+    if (equals == string_view::npos)
+        return false;
+    string_view name = prop.substr(0, equals);
+    p.value = prop.substr(equals + 1);
+    const auto digit = [](char c) { return c >= '0' && c <= '9'; };
+    if (name.size() >= 2 && name.back() == ' ' &&
+        digit(name[name.size() - 2])) {
+        p.spaceAfterNumber = true;
+        p.number = name[name.size() - 2];
+        name.remove_suffix(2);
+    } else {
+        for (; !name.empty() && name.back() == '*'; p.stars++)
+            name.remove_suffix(1);
+        if (!name.empty() && digit(name.back())) {
+            p.number = name.back();
+            name.remove_suffix(1);
+        } else {
+            p.strength = tryEatB(name, "stark") || tryEatB(name, "schwach") ||
+                         tryEatB(name, "gemischt");
         }
     }
-
-    return results;
+    const size_t end = name.size();
+    while (!name.empty() && std::isspace((unsigned char)name.back()))
+        name.remove_suffix(1);
+    p.gap = string_view(name.data() + name.size(), end - name.size());
+    p.name = name;
+    return true;
 }
 
-vector<string> parseSectionTitle(const string &title) {
-    const static thread_local std::regex parens(
-        R"(\}\}, \{\{)");
-    return vecMap<string>(
-        leading<1>(title, parens, true),
-        [](const tuple<string, string> x) { return trim(get<1>(x)); });
+// Whether the numbering of p is one the tables use for a parameter of kind.
+// Forms are numbered by up to five stars, maybe after stark, schwach or
+// gemischt, or by a number from 1 to 5 with up to two stars. A bare name
+// followed by a space is the start of a longer one, like "Nominativ Plural".
+static bool takes(const ParamName &p, ParamKind kind) {
+    const bool numbered = p.number >= '1' && p.number <= '5';
+    switch (kind) {
+    case ParamKind::bare:
+        if (!p.gap.empty() && p.gap[0] == ' ')
+            return false;
+        [[fallthrough]];
+    case ParamKind::forms:
+        return p.number == 0 ? p.stars <= 5 : numbered && p.stars <= 2;
+    case ParamKind::persons:
+        return p.number == 0 && !p.strength && p.gap.empty() && p.stars <= 3;
+    case ParamKind::genus:
+        if (p.number == 0)
+            return !p.strength && p.stars == 0 &&
+                   (p.gap.empty() || p.gap == " ");
+        return numbered && p.number <= '4' && p.stars == 0 &&
+               !p.spaceAfterNumber && p.gap == " ";
+    }
+    return false;
 }
 
-template <size_t max> bool collectNumeri(string &prop, Numeri &target) {
-    if (tryEat(prop, "Singular"))
-        return collectStarsNumbers<max>(prop, target.singular);
-    else if (tryEat(prop, "Plural"))
-        return collectStarsNumbers<max>(prop, target.plural);
-    return false;
+// The parameter of table that prop is, with its name and value in p, or
+// nullptr
+template <typename Table>
+static const Param *findParam(const string_view &prop, const Table &table,
+                              ParamName &p) {
+    return splitParam(prop, p) ? table.find(p.name) : nullptr;
 }
 
-template <size_t max>
-bool collectNumbered(string &prop, vector<string> &target) {
-    trimHere(prop);
-    for (size_t i = 0; i <= max; i++) {
-        const string base = (i > 0 ? std::to_string(i) : "");
-        if (tryEat(prop, base + "=") || tryEat(prop, base + "*=") ||
-            tryEat(prop, base + " =") || tryEat(prop, base + "**=")) {
-            target.push_back(saniWiki(prop));
-            return true;
-        }
+// Adds the value of the parameter prop of the given kind to target, if its
+// numbering is one the tables use
+static void collect(const string_view &prop, const ParamName &p,
+                    ParamKind kind, vector<string> &target) {
+    if (!takes(p, kind)) {
+        diagnose(Problem::collectionFailed, prop);
+        return;
     }
-    return false;
+    // Forms end at the end of the trimmed parameter, which decides whether
+    // saniWiki keeps an &amp; at their end
+    string_view value = p.value;
+    if (kind != ParamKind::persons)
+        value = trim(prop).substr(prop.size() - value.size());
+    target.push_back(saniWiki(value));
 }
 
-template <size_t max> bool collectStars(string &prop, vector<string> &target) {
-    string stars = "";
-    trimHere(prop);
-    for (size_t i = 0; i <= max; i++) {
-        if (tryEat(prop, stars + "=") || tryEat(prop, "stark" + stars + "=") ||
-            tryEat(prop, "schwach" + stars + "=") ||
-            tryEat(prop, "gemischt" + stars + "=")) {
-            target.push_back(saniWiki(prop));
-            return true;
-        }
-        stars += "*";
+// The parameters of the declension tables of nouns, 2 * case + plural
+static constexpr Keyword<Param> nounParamList[] = {
+    {"Nominativ Singular", {ParamKind::forms, 0}},
+    {"Nominativ Plural", {ParamKind::forms, 1}},
+    {"Genitiv Singular", {ParamKind::forms, 2}},
+    {"Genitiv Plural", {ParamKind::forms, 3}},
+    {"Dativ Singular", {ParamKind::forms, 4}},
+    {"Dativ Plural", {ParamKind::forms, 5}},
+    {"Akkusativ Singular", {ParamKind::forms, 6}},
+    {"Akkusativ Plural", {ParamKind::forms, 7}},
+    // Names like Dativ*=Jesu
+    {"Nominativ", {ParamKind::bare, 0}},
+    {"Genitiv", {ParamKind::bare, 2}},
+    {"Dativ", {ParamKind::bare, 4}},
+    {"Akkusativ", {ParamKind::bare, 6}},
+    {"Singular", {ParamKind::forms, 0}},
+    {"Plural", {ParamKind::forms, 1}},
+    {"Genus", {ParamKind::genus, 0}},
+};
+static constexpr auto nounParams = keywordTable(nounParamList);
+
+enum VerbForms : uint8_t {
+    presentFirst,
+    presentSecond,
+    presentThird,
+    preterite,
+    participle,
+    irrealis,
+    subjunctive,
+    imperativeSingular,
+    imperativePlural,
+    auxiliary,
+};
+
+// The parameters of the conjugation tables of verbs
+static constexpr Keyword<Param> verbParamList[] = {
+    {"Präsens_ich", {ParamKind::persons, presentFirst}},
+    {"Präsens_du", {ParamKind::persons, presentSecond}},
+    {"Präsens_er, sie, es", {ParamKind::persons, presentThird}},
+    {"Gegenwart_ich", {ParamKind::persons, presentFirst}},
+    {"Gegenwart_du", {ParamKind::persons, presentSecond}},
+    {"Gegenwart_er, sie, es", {ParamKind::persons, presentThird}},
+    {"Präteritum_ich", {ParamKind::forms, preterite}},
+    {"Partizip II", {ParamKind::forms, participle}},
+    {"Konjunktiv II_ich", {ParamKind::forms, irrealis}},
+    {"Konjunktiv I_ich", {ParamKind::forms, subjunctive}},
+    {"Imperativ Singular", {ParamKind::forms, imperativeSingular}},
+    {"Imperativ Plural", {ParamKind::forms, imperativePlural}},
+    {"Befehl_du", {ParamKind::forms, imperativeSingular}},
+    {"Befehl_ihr", {ParamKind::forms, imperativePlural}},
+    {"Hilfsverb", {ParamKind::forms, auxiliary}},
+};
+static constexpr auto verbParams = keywordTable(verbParamList);
+
+static vector<string> &verbForms(Verb &v, uint8_t target) {
+    switch (target) {
+    case presentFirst:
+        return v.base.present.first.singular;
+    case presentSecond:
+        return v.base.present.second.singular;
+    case presentThird:
+        return v.base.present.third.singular;
+    case preterite:
+        return v.base.preterite_firstSingular;
+    case participle:
+        return v.base.participleII;
+    case irrealis:
+        return v.base.irrealis_firstSingular;
+    case subjunctive:
+        return v.base.subjunctive_firstSingular;
+    case imperativeSingular:
+        return v.imperative.singular;
+    case imperativePlural:
+        return v.imperative.plural;
+    default:
+        return v.base.auxiliary;
     }
-    return false;
 }
 
-template <size_t max>
-bool collectStarsNumbers(string &prop, vector<string> &target) {
-    if (collectStars<max>(prop, target))
-        return true;
-    if (collectNumbered<max>(prop, target))
-        return true;
-
-    cout << "Error: Collection failed : " << prop << endl;
-    return false;
+// The parameters of the comparison tables of adjectives and adverbs
+static constexpr Keyword<Param> degreeParamList[] = {
+    {"Positiv", {ParamKind::forms, 0}},
+    {"Komparativ", {ParamKind::forms, 1}},
+    {"Superlativ", {ParamKind::forms, 2}},
+};
+static constexpr auto degreeParams = keywordTable(degreeParamList);
+
+template <typename T>
+static vector<string> &degreeForms(T &word, uint8_t target) {
+    return target == 0 ? word.positive
+                       : target == 1 ? word.comparative : word.superlative;
 }
 
-void collectPersons(string &prop, Person &target) {
-    string stars = "";
-    for (size_t i = 0; i < 4; i++) {
-        if (tryEat(prop, "ich" + stars + "="))
-            target.first.singular.push_back(saniWiki(prop));
-        else if (tryEat(prop, "du" + stars + "="))
-            target.second.singular.push_back(saniWiki(prop));
-        else if (tryEat(prop, "er, sie, es" + stars + "="))
-            target.third.singular.push_back(saniWiki(prop));
-        else
-            stars += "*";
-    }
+// The first of list that is type or that mType contains, the same as checking
+// them in order. mType is mostly one word class that contained knows.
+template <typename V, size_t N>
+static size_t findType(const Keyword<V> (&list)[N],
+                       const KeywordTable<size_t, N> &index,
+                       const KeywordTable<size_t, N> &contained,
+                       const string_view &type, const string_view &mType) {
+    size_t first = N;
+    if (const size_t *exact = index.find(type))
+        first = *exact;
+    string_view single = mType;
+    const size_t *known = tryEat(single, " ") ? contained.find(single) : nullptr;
+    return std::min(first, known ? *known : firstContained(mType, list));
 }
 
-const static thread_local std::regex vertSep(R"(\n\|)");
-void buildNoun(const string &type, const string &mType, const string &body,
-               const string &title, Dictionary &dict,
-               const string &worttrennung) {
+void buildNoun(const string_view &type, const string_view &mType,
+               const string_view &body, const string_view &title,
+               Dictionary &dict, const string_view &worttrennung) {
     Noun n;
     bool some = false;
     if (has(type, "name") || has(mType, "name") || has(type, "Name") ||
@@ -359,35 +406,19 @@ void buildNoun(const string &type, const string &mType, const string &body,
     // TODO: Toponym genus in title
     // TODO: kPl. in Worttrennung
 
-    for (const auto c_prop : leading<1>(body, vertSep)) {
+    for (const auto &c_prop : leading(body, Literal("\n|"))) {
         some = true;
-        string prop(get<1>(c_prop));
-        if (tryEat(prop, "Nominativ "))
-            collectNumeri<5>(prop, n.nominative);
-        else if (tryEat(prop, "Nominativ") || tryEat(prop, "Singular"))
-            collectStarsNumbers<5>(prop, n.nominative.singular);
-        else if (tryEat(prop, "Plural"))
-            collectStarsNumbers<5>(prop, n.nominative.plural);
-        else if (tryEat(prop, "Genitiv "))
-            collectNumeri<5>(prop, n.genitive);
-        else if (tryEat(prop, "Genitiv"))
-            collectStarsNumbers<5>(
-                prop,
-                n.genitive.singular); // names like Dativ*=Jesu
-        else if (tryEat(prop, "Dativ "))
-            collectNumeri<5>(prop, n.dative);
-        else if (tryEat(prop, "Dativ"))
-            collectStarsNumbers<5>(prop, n.dative.singular);
-        else if (tryEat(prop, "Akkusativ "))
-            collectNumeri<5>(prop, n.accusative);
-        else if (tryEat(prop, "Akkusativ"))
-            collectStarsNumbers<5>(prop, n.accusative.singular);
-        else if (tryEat(prop, "Genus=") || tryEat(prop, "Genus =") ||
-                 tryEat(prop, "Genus 1=") || tryEat(prop, "Genus 2=") ||
-                 tryEat(prop, "Genus 3=") || tryEat(prop, "Genus 4=")) {
-            n.genus.n = has(prop, "n");
-            n.genus.m = has(prop, "m");
-            n.genus.f = has(prop, "f");
+        string_view prop = get<1>(c_prop);
+        ParamName p;
+        const Param *param = findParam(prop, nounParams, p);
+        if (param && param->kind != ParamKind::genus) {
+            Numeri &c = n.cases[param->target / 2];
+            collect(prop, p, param->kind,
+                    param->target % 2 ? c.plural : c.singular);
+        } else if (param && takes(p, ParamKind::genus)) {
+            n.genus.n = has(p.value, "n");
+            n.genus.m = has(p.value, "m");
+            n.genus.f = has(p.value, "f");
         } else if (tryEat(prop, "kein Singular=") ||
                    has(worttrennung, "{{kSg.}}")) {
             n.noSingular = true;
@@ -399,8 +430,7 @@ void buildNoun(const string &type, const string &mType, const string &body,
                    tryEat(prop, "Stamm=") || tryEat(prop, "kein-s=")) {
             // drop
         } else {
-            cout << "Error: unknown prop subs: " << prop << " (" << mType << ")"
-                 << endl;
+            diagnose(Problem::unknownNounProp, prop, " (", mType, ")");
         }
     }
 
@@ -418,14 +448,15 @@ void buildNoun(const string &type, const string &mType, const string &body,
     if (some || n.type == NounType::Name || n.type == NounType::Toponym)
         dict.add(n);
     else
-        cout << "Error: " << title << " was empty (Noun)" << endl;
+        diagnose(Problem::emptyEntry, "Noun");
 }
 
-void buildPronoun(const string &type, const string &mType, const string &body,
-                  const string &title, Dictionary &dict,
-                  const string &worttrennung, const string &genderSuffix) {
+void buildPronoun(const string_view &type, const string_view &mType,
+                  const string_view &body, const string_view &title,
+                  Dictionary &dict, const string_view &worttrennung,
+                  const string &genderSuffix) {
     Pronoun p;
-    const static thread_local vector<pair<string, pronounType>> lookup = {
+    static constexpr Keyword<pronounType> lookup[] = {
         {"Personalpronomen", pronounType::Personal},
         {"Reflexives Personalpronomen", pronounType::Personal},
         {"Possessivpronomen", pronounType::Possessive},
@@ -437,22 +468,20 @@ void buildPronoun(const string &type, const string &mType, const string &body,
         {"Indefinitpronomen", pronounType::Indefinite},
         {"Artikel", pronounType::Article},
     };
-    p.type = pronounType::unknown;
-    for (const auto &l : lookup) {
-        if (type == l.first || has(mType, l.first)) {
-            p.type = l.second;
-            break;
-        }
-    }
+    static constexpr auto index = indexKeywords(lookup);
+    static constexpr auto contained = containedKeywords(lookup, lookup);
+    const size_t found = findType(lookup, index, contained, type, mType);
+    p.type = found < std::size(lookup) ? lookup[found].value
+                                       : pronounType::unknown;
     if (p.type == pronounType::unknown) {
-        cout << "Error: unknown pronoun " << type << endl;
+        diagnose(Problem::unknownPronoun, type);
     }
 
     bool some = false;
     bool genderM = false, genderF = false, genderN = false;
-    for (const auto c_prop : leading<1>(body, vertSep)) {
+    for (const auto &c_prop : leading(body, Literal("\n|"))) {
         some = true;
-        string prop(get<1>(c_prop));
+        string_view prop = get<1>(c_prop);
 
         Numeri *theCase = nullptr;
 
@@ -466,15 +495,15 @@ void buildPronoun(const string &type, const string &mType, const string &body,
             theCase = &p.accusative;
 
         if (theCase) {
-            string tryGender = "";
+            string_view tryGender;
             if (tryEat(prop, "Singular ")) {
                 if (tryEat(prop, genderSuffix + "="))
-                    theCase->singular.push_back(prop);
+                    theCase->singular.push_back(string(prop));
                 else
                     tryGender = prop;
             } else if (tryEat(prop, "Plural ")) {
                 if (tryEat(prop, genderSuffix + "="))
-                    theCase->plural.push_back(prop);
+                    theCase->plural.push_back(string(prop));
                 else
                     tryGender = prop;
             }
@@ -499,7 +528,7 @@ void buildPronoun(const string &type, const string &mType, const string &body,
         } else if (tryEat(prop, "Bild")) {
             // drop
         } else {
-            cout << "Error: unknown prop: " << prop << endl;
+            diagnose(Problem::unknownPronounProp, prop);
         }
     }
 
@@ -511,16 +540,15 @@ void buildPronoun(const string &type, const string &mType, const string &body,
     // ich, {{Gen.}} mei·ner, {{va.|:}} mein, {{Dat.}} mir, {{Akk.}} mich;
     // {{Pl.}} wir
     if (worttrennung.size() > 3) {
-        const static thread_local std::regex wortRe(R"(,|;)");
-        vector<string> sections =
-            vecMap<string>(leading<1>(worttrennung, wortRe, true),
-                           [](auto p) { return trim(get<1>(p)); });
+        std::pmr::vector<string_view> sections(scratch());
+        for (const Part &x : leading(worttrennung, AnyOf(",;"), true))
+            sections.push_back(trim(get<1>(x)));
         bool plural = false;
         Numeri *base = &p.nominative;
         bool first = true;
         bool pluralAp = false;
 
-        for (string s : sections) {
+        for (string_view s : sections) {
             if (tryEat(s, "{{Gen.}}")) {
                 base = &p.genitive;
             } else if (tryEat(s, "{{Dat.}}")) {
@@ -531,8 +559,7 @@ void buildPronoun(const string &type, const string &mType, const string &body,
                 base = &p.nominative;
                 plural = true;
                 if (pluralAp)
-                    cout << "Error: Multiple Plural declarations -  "
-                         << worttrennung << endl;
+                    diagnose(Problem::multiplePlurals, worttrennung);
                 pluralAp = true;
             } else if (tryEat(s, "{{va.|:}}") ||
                        tryEat(s, R"(''veraltet:'')")) { // Veraltet
@@ -541,8 +568,8 @@ void buildPronoun(const string &type, const string &mType, const string &body,
                                                 // to parse this!
                 break;
             } else if (!first) {
-                cout << "Error: unknown case - \"" << s << "\"  "
-                     << worttrennung << endl;
+                diagnose(Problem::unknownCase, "\"", s, "\"  ",
+                         worttrennung);
                 break;
             }
             first = false;
@@ -559,95 +586,95 @@ void buildPronoun(const string &type, const string &mType, const string &body,
     }
 
     if (p.nominative.singular.empty()) {
-        p.nominative.singular.push_back(title);
+        p.nominative.singular.push_back(string(title));
         some = true;
     }
 
     if (some)
         dict.add(p);
     else
-        cout << "Error: " << title << " was empty (pronoun)" << endl;
+        diagnose(Problem::emptyEntry, "pronoun");
+}
+
+static uint32_t caseSlot(Cases c, bool plural) {
+    return uint32_t(1) << (2 * size_t(c) + plural);
 }
 
-vector<vector<string> *> eatToCases(string &s, WithCases &c, bool printErr) {
+// The forms the start of s names, as bits of InflectedForm::slots
+uint32_t eatToCases(string_view &s, bool printErr) {
     if (tryEat(s, "Nominativ Singular"))
-        return {&c.nominative.singular};
+        return caseSlot(Cases::Nominative, false);
     else if (tryEat(s, "Nominativ Plural"))
-        return {&c.nominative.plural};
+        return caseSlot(Cases::Nominative, true);
     else if (tryEat(s, "Genitiv Singular"))
-        return {&c.genitive.singular};
+        return caseSlot(Cases::Genitive, false);
     else if (tryEat(s, "Genitiv Plural"))
-        return {&c.genitive.plural};
+        return caseSlot(Cases::Genitive, true);
     else if (tryEat(s, "Dativ Singular") ||
              tryEat(s, "{{Dativ-e}} Dativ Singular"))
-        return {&c.dative.singular};
+        return caseSlot(Cases::Dative, false);
     else if (tryEat(s, "Dativ Plural"))
-        return {&c.dative.plural};
+        return caseSlot(Cases::Dative, true);
     else if (tryEat(s, "Akkusativ Singular") || tryEat(s, "Akusativ Singular"))
-        return {&c.accusative.singular};
+        return caseSlot(Cases::Accusative, false);
     else if (tryEat(s, "Akkusativ Plural") || tryEat(s, "Akusativ Plural"))
-        return {&c.accusative.plural};
+        return caseSlot(Cases::Accusative, true);
     else if (tryEat(s, "Alle Kasus Singular") || tryEat(s, "Singular"))
-        return {&c.nominative.singular, &c.genitive.singular,
-                &c.dative.singular, &c.accusative.singular};
+        return caseSlot(Cases::Nominative, false) |
+               caseSlot(Cases::Genitive, false) |
+               caseSlot(Cases::Dative, false) |
+               caseSlot(Cases::Accusative, false);
     else if (tryEat(s, "Alle Kasus Plural") || tryEat(s, "Plural"))
-        return {&c.nominative.plural, &c.genitive.plural, &c.dative.plural,
-                &c.accusative.plural};
+        return caseSlot(Cases::Nominative, true) |
+               caseSlot(Cases::Genitive, true) |
+               caseSlot(Cases::Dative, true) |
+               caseSlot(Cases::Accusative, true);
     else if (tryEat(s, "Prädikative und adverbielle Form")) {
-        return {}; // This is just what is
+        return 0; // This is just what is
     } else {
         if (printErr)
-            cout << "Error: unknown Noun/Adjective Declination: " << s << endl;
-        return {};
+            diagnose(Problem::unknownDeclination, s);
+        return 0;
     }
 }
 
-void buildDeklinierteForm(Dictionary &dict, string &body,
-                          const string &targetWord, const string &value,
+void buildDeklinierteForm(FormIndex &forms, string_view &body,
+                          const string_view &targetWord,
+                          const string_view &value,
                           pronounType p, bool printErr) {
 
-    Pronoun n;
-    n.type = p;
-    n.nominative.singular.push_back(saniWiki(targetWord));
-
-    vector<vector<string> *> target = eatToCases(body, n, printErr);
-    if (target.empty())
+    InflectedForm f;
+    f.slots = eatToCases(body, printErr);
+    if (f.slots == 0)
         return;
-    const string sWord = saniWiki(value);
-    for (const auto &t : target)
-        t->push_back(sWord);
-    dict.add(n);
+    f.form = saniWiki(value);
+    f.lemma = saniWiki(targetWord);
+    f.detail = uint8_t(p);
+    f.formIsKey = f.slots & nominativeSingular;
+    forms.pronouns.push_back(std::move(f));
 }
 
-void buildDeclAdjective(Adjective &a, size_t stAndGenus, const string &word,
-                        string s, bool printErr) {
+// The forms of one genus of the adjective s names and their degree
+uint32_t buildDeclAdjective(uint8_t &degree, string_view s, bool printErr) {
 
     if (tryEatB(s, " des Superlativs")) {
-        stAndGenus += 6;
+        degree = 2;
     } else if (tryEatB(s, " des Komparativs")) {
-        stAndGenus += 3;
+        degree = 1;
     } else /*if (tryEatB(s, " des Positivs"))*/ {
-        stAndGenus += 0;
+        degree = 0;
     }
 
-    vector<vector<string> *> target =
-        eatToCases(s, a.cases[stAndGenus], printErr);
-    if (target.empty())
-        return;
-
-    const string sWord = saniWiki(word);
-    for (const auto &t : target)
-        t->push_back(sWord);
+    return eatToCases(s, printErr);
 }
 
-void buildDeklinierteFormVerb(Dictionary &dict, string &s,
-                              const string &targetWord, const string &value) {
-
-    const string sWord = saniWiki(value);
+void buildDeklinierteFormVerb(FormIndex &forms, string_view &s,
+                              const string_view &targetWord,
+                              const string_view &value) {
 
-    Verb v;
-
-    v.base.presentInfinitive.push_back(saniWiki(targetWord));
+    InflectedForm f;
+    f.form = saniWiki(value);
+    f.lemma = saniWiki(targetWord);
 
     Verbspec spec(Verbspec::Present);
 
@@ -664,7 +691,7 @@ void buildDeklinierteFormVerb(Dictionary &dict, string &s,
         } else if (tryEat(s, "3. Person")) {
             spec.person = Verbspec::Third;
         } else {
-            cout << "Error: unknown person " << s << endl;
+            diagnose(Problem::unknownPerson, s);
             return;
         }
         tryEat(s, " ");
@@ -674,7 +701,7 @@ void buildDeklinierteFormVerb(Dictionary &dict, string &s,
         else if (tryEat(s, "Plural"))
             spec.number = Verbspec::Plural;
         else
-            cout << "Error: unexpected number " << s << endl;
+            diagnose(Problem::unexpectedNumber, s);
         tryEat(s, " ");
 
         if (tryEat(s, "Indikativ")) {
@@ -686,7 +713,7 @@ void buildDeklinierteFormVerb(Dictionary &dict, string &s,
         }  else if (tryEat(s, "Imperativ")) {
             spec.mode = Verbspec::Imperative;
         } else {
-            cout << "Error: unknown mode " << s << endl;
+            diagnose(Problem::unknownMode, s);
             return;
         }
         tryEat(s, " ");
@@ -704,131 +731,117 @@ void buildDeklinierteFormVerb(Dictionary &dict, string &s,
         } else if (tryEat(s, "Futur II")) {
             spec.tempus = Verbspec::FutureII;
         } else {
-            cout << "Error: unknown mode " << s << endl;
+            diagnose(Problem::unknownMode, s);
             return;
         }
         tryEat(s, " ");
     }
 
-    if (!v.set(spec, sWord)) {
-        cout << "Error: Couldn't set : " << sWord << endl;
+    const size_t slot = verbSlotOf(spec);
+    if (slot == verbSlots) {
+        diagnose(Problem::unsetForm, f.form);
+    } else {
+        f.slots = uint32_t(1) << slot;
     }
-    
 
-    dict.add(v);
+    forms.verbs.push_back(std::move(f));
 }
 
-void buildDeklinierteForm(Dictionary &dict, const string &grammatischeMerkmale,
-                          const string &word, bool printErr) {
+void buildDeklinierteForm(FormIndex &forms,
+                          const string_view &grammatischeMerkmale,
+                          const string_view &word, bool printErr) {
 
-    const static thread_local std::regex gM(
-        R"(\[\[(\w+)\]\])");
-    for (const auto &ref : tailing<1>(grammatischeMerkmale, gM)) {
+    for (const auto &ref : tailing(grammatischeMerkmale, LinkMatcher())) {
 
         // TODO: muss "der gemischten Flexion" und "der schwachen Flexion"
         // unterschieden werden?
 
-        string s = trim(get<1>(ref));
+        const string_view lemma = get<0>(ref);
+        string_view s = trim(get<1>(ref));
         tryEat(s, "'''\n"), tryEat(s, "\n"), tryEat(s, "*");
         tryEatB(s, "'''");
         s = trim(s);
 
         if (tryEatB(s, " des Adjektivs")) {
-            Adjective a;
-            a.positive.push_back(saniWiki(get<0>(ref)));
+            InflectedForm f;
+            f.form = saniWiki(word);
+            f.lemma = saniWiki(lemma);
 
+            // The same forms for every genus it names
+            const uint32_t cases = buildDeclAdjective(f.detail, s, printErr);
             if (has(s, " Maskulinum")) {
-                buildDeclAdjective(a, 0, word, s, printErr);
+                f.slots = cases;
             } else if (has(s, " Femininum")) {
-                buildDeclAdjective(a, 1, word, s, printErr);
+                f.slots = cases << 8;
             } else if (has(s, " Neutrum")) {
-                buildDeclAdjective(a, 2, word, s, printErr);
+                f.slots = cases << 16;
             } else /*if (has(s, " alle Genera")) */ {
-                buildDeclAdjective(a, 0, word, s, printErr);
-                buildDeclAdjective(a, 1, word, s, printErr);
-                buildDeclAdjective(a, 2, word, s, printErr);
+                f.slots = cases | cases << 8 | cases << 16;
             }
 
-            dict.add(a);
+            forms.adjectives.push_back(std::move(f));
 
         } else if (has(s, " des Substantivs")) {
-            Noun n;
-            n.type = NounType::Incomplete;
-            n.nominative.singular.push_back(saniWiki(get<0>(ref)));
-
-            vector<vector<string> *> target = eatToCases(s, n, printErr);
-            if (target.empty())
+            InflectedForm f;
+            f.slots = eatToCases(s, printErr);
+            if (f.slots == 0)
                 return;
-            const string sWord = saniWiki(word);
-            for (const auto &t : target)
-                t->push_back(sWord);
-            dict.add(n);
+            f.form = saniWiki(word);
+            f.lemma = saniWiki(lemma);
+            f.formIsKey = f.slots & nominativeSingular;
+            forms.nouns.push_back(std::move(f));
 
         } else if (tryEatB(s, " des Personalpronomens")) {
-            buildDeklinierteForm(dict, s, get<0>(ref), word,
+            buildDeklinierteForm(forms, s, lemma, word,
                                  pronounType::Personal, printErr);
         } else if (tryEatB(s, " des Possessivpronomens")) {
-            buildDeklinierteForm(dict, s, get<0>(ref), word,
+            buildDeklinierteForm(forms, s, lemma, word,
                                  pronounType::Possessive, printErr);
         } else if (tryEatB(s, " des Reflexivpronomens")) {
-            buildDeklinierteForm(dict, s, get<0>(ref), word,
+            buildDeklinierteForm(forms, s, lemma, word,
                                  pronounType::Reflexive, printErr);
         } else if (tryEatB(s, " des Indefinitpronomens")) {
-            buildDeklinierteForm(dict, s, get<0>(ref), word,
+            buildDeklinierteForm(forms, s, lemma, word,
                                  pronounType::Indefinite, printErr);
         } else if (tryEatB(s, " des Demonstrativpronomens")) {
-            buildDeklinierteForm(dict, s, get<0>(ref), word,
+            buildDeklinierteForm(forms, s, lemma, word,
                                  pronounType::Demonstrative, printErr);
         } else if (tryEatB(s, " des Relativpronomens")) {
-            buildDeklinierteForm(dict, s, get<0>(ref), word,
+            buildDeklinierteForm(forms, s, lemma, word,
                                  pronounType::Relative, printErr);
         } else if (has(s, " des Verbs")) {
-            buildDeklinierteFormVerb(dict, s, get<0>(ref), word);
+            buildDeklinierteFormVerb(forms, s, lemma, word);
         } else {
             if (printErr)
-                cout << "Error: unknown 'deklinierte Form' " << s << endl;
+                diagnose(Problem::unknownDeclinedForm, s);
         }
     }
 }
 
-void parseWord(Dictionary &dict, Dictionary &dictIncom, const string &title,
-               const string &type, const string &body,
-               const string &worttrennung, const string &grammatischeMerkmale,
-               bool print, const string &mType) {
+void parseWord(Dictionary &dict, FormIndex &forms,
+               const string_view &title, const string_view &type,
+               const string_view &body, const string_view &worttrennung,
+               const string_view &grammatischeMerkmale, bool print,
+               const string_view &mType) {
 
     if (print)
         cout << "      " << title << endl;
 
     if (has(mType, "Deklinierte Form") || has(mType, "Konjugierte Form")) {
-        buildDeklinierteForm(dictIncom, grammatischeMerkmale, title,
+        const StageTimer timer(Stage::buildDeclined);
+        buildDeklinierteForm(forms, grammatischeMerkmale, title,
                              false); // TODO: debug: printErr = false
 
     } else if (has(type, "Verb") || type == "verb" || has(mType, "Verb")) {
+        const StageTimer timer(Stage::buildVerb);
         Verb v;
         bool some = false;
-        for (const auto c_prop : leading<1>(body, vertSep)) {
+        for (const auto &c_prop : leading(body, Literal("\n|"))) {
             some = true;
-            string prop(get<1>(c_prop));
-            if (tryEat(prop, "Präsens_"))
-                collectPersons(prop, v.base.present);
-            else if (tryEat(prop, "Gegenwart_"))
-                collectPersons(prop, v.base.present);
-            else if (tryEat(prop, "Präteritum_ich"))
-                collectStarsNumbers<5>(prop, v.base.preterite_firstSingular);
-            else if (tryEat(prop, "Partizip II"))
-                collectStarsNumbers<5>(prop, v.base.participleII);
-            else if (tryEat(prop, "Konjunktiv II_ich"))
-                collectStarsNumbers<5>(prop, v.base.irrealis_firstSingular);
-            else if (tryEat(prop, "Konjunktiv I_ich"))
-                collectStarsNumbers<5>(prop, v.base.subjunctive_firstSingular);
-            else if (tryEat(prop, "Imperativ "))
-                collectNumeri<5>(prop, v.imperative);
-            else if (tryEat(prop, "Befehl_du"))
-                collectStarsNumbers<5>(prop, v.imperative.singular);
-            else if (tryEat(prop, "Befehl_ihr"))
-                collectStarsNumbers<5>(prop, v.imperative.plural);
-            else if (tryEat(prop, "Hilfsverb")) {
-                collectStarsNumbers<5>(prop, v.base.auxiliary);
+            string_view prop = get<1>(c_prop);
+            ParamName p;
+            if (const Param *param = findParam(prop, verbParams, p)) {
+                collect(prop, p, param->kind, verbForms(v, param->target));
             } else if (tryEat(prop, "unpersönlich=")) {
                 // TODO
             } else if (tryEat(prop, "Weitere Konjugationen=") ||
@@ -837,7 +850,7 @@ void parseWord(Dictionary &dict, Dictionary &dictIncom, const string &title,
             } else if (tryEat(prop, "Bild") || tryEat(prop, "Flexion=")) {
                 // drop
             } else {
-                cout << "Error: unknown prop verb: " << prop << endl;
+                diagnose(Problem::unknownVerbProp, prop);
             }
         }
         if (v.base.presentInfinitive.empty())
@@ -845,20 +858,18 @@ void parseWord(Dictionary &dict, Dictionary &dictIncom, const string &title,
         if (some)
             dict.add(v);
         else
-            cout << "Error: " << title << " was empty (verb)" << endl;
+            diagnose(Problem::emptyEntry, "verb");
 
     } else if (has(type, "Adjektiv") || has(mType, "Adjektiv")) {
+        const StageTimer timer(Stage::buildAdjective);
         Adjective a;
         bool some = false;
-        for (const auto c_prop : leading<1>(body, vertSep)) {
+        for (const auto &c_prop : leading(body, Literal("\n|"))) {
             some = true;
-            string prop(get<1>(c_prop));
-            if (tryEat(prop, "Positiv"))
-                collectStarsNumbers<5>(prop, a.positive);
-            else if (tryEat(prop, "Komparativ"))
-                collectStarsNumbers<5>(prop, a.comparative);
-            else if (tryEat(prop, "Superlativ"))
-                collectStarsNumbers<5>(prop, a.superlative);
+            string_view prop = get<1>(c_prop);
+            ParamName p;
+            if (const Param *param = findParam(prop, degreeParams, p))
+                collect(prop, p, param->kind, degreeForms(a, param->target));
             else if (tryEat(prop, "keine weiteren Formen=ja") ||
                      tryEat(prop, "keine weiteren Formen=1")) {
                 // TODO
@@ -867,7 +878,7 @@ void parseWord(Dictionary &dict, Dictionary &dictIncom, const string &title,
             } else if (tryEat(prop, "Bild") || tryEat(prop, "Flexion=")) {
                 // drop
             } else {
-                cout << "Error: unknown prop adj: " << prop << endl;
+                diagnose(Problem::unknownAdjectiveProp, prop);
             }
         }
 
@@ -879,10 +890,11 @@ void parseWord(Dictionary &dict, Dictionary &dictIncom, const string &title,
         if (some)
             dict.add(a);
         else
-            cout << "Error: " << title << " was empty (adjective)" << endl;
+            diagnose(Problem::emptyEntry, "adjective");
 
     } else if (has(type, "ronomen") || has(mType, "ronomen") ||
                has(mType, "Artikel")) {
+        const StageTimer timer(Stage::buildPronoun);
         buildPronoun(type, mType, body, title, dict, worttrennung, "");
 
     } else if (has(mType, "partikel") || has(mType, "Partikel") ||
@@ -893,9 +905,10 @@ void parseWord(Dictionary &dict, Dictionary &dictIncom, const string &title,
                          "Grußformel", "Konjunktion"})) {
 
         bool some = false;
+        const StageTimer timer(Stage::buildAdverb);
         Adverb a;
 
-        const static thread_local vector<pair<string, AdverbType>> lookup = {
+        static constexpr Keyword<AdverbType> lookup[] = {
             {"Partikel", AdverbType::particle},
             {"Antwortpartikel", AdverbType::particle},
             {"Gradpartikel", AdverbType::particle},
@@ -924,30 +937,25 @@ void parseWord(Dictionary &dict, Dictionary &dictIncom, const string &title,
             {"Relativadverb", AdverbType::adverb},
             {"Interrogativadverb", AdverbType::adverb},
         };
-        a.type = AdverbType::unknown;
-        for (const auto &l : lookup) {
-            if (type == l.first || has(mType, l.first)) {
-                a.type = l.second;
-                break;
-            }
-        }
+        static constexpr auto index = indexKeywords(lookup);
+        static constexpr auto contained = containedKeywords(lookup, lookup);
+        const size_t found = findType(lookup, index, contained, type, mType);
+        a.type = found < std::size(lookup) ? lookup[found].value
+                                           : AdverbType::unknown;
         if (a.type == AdverbType::unknown) {
-            cout << "Error: unknown adverb " << type << " " << mType << endl;
+            diagnose(Problem::unknownAdverb, type, " ", mType);
         }
 
-        for (const auto c_prop : leading<1>(body, vertSep)) {
+        for (const auto &c_prop : leading(body, Literal("\n|"))) {
             some = true;
-            string prop(get<1>(c_prop));
-            if (tryEat(prop, "Positiv"))
-                collectStarsNumbers<5>(prop, a.positive);
-            else if (tryEat(prop, "Komparativ"))
-                collectStarsNumbers<5>(prop, a.comparative);
-            else if (tryEat(prop, "Superlativ"))
-                collectStarsNumbers<5>(prop, a.superlative);
+            string_view prop = get<1>(c_prop);
+            ParamName p;
+            if (const Param *param = findParam(prop, degreeParams, p))
+                collect(prop, p, param->kind, degreeForms(a, param->target));
             else if (tryEat(prop, "Bild") || tryEat(prop, "Flexion=")) {
                 // drop
             } else {
-                cout << "Error: unknown prop adv: " << prop << endl;
+                diagnose(Problem::unknownAdverbProp, prop);
             }
         }
 
@@ -960,6 +968,7 @@ void parseWord(Dictionary &dict, Dictionary &dictIncom, const string &title,
                has(type, "Toponym") || has(mType, "Toponym") ||
                has(mType, "Numeral")) {
 
+        const StageTimer timer(Stage::buildNoun);
         buildNoun(type, mType, body, title, dict, worttrennung);
 
     } else if (has(mType, "Erweiterter Infinitiv")) {
@@ -990,44 +999,99 @@ void parseWord(Dictionary &dict, Dictionary &dictIncom, const string &title,
                                 "Merkspruch"})) {
         // TODO: Drop?
     } else {
-        cout << "Error: unknown class: (" << type << ") (" << mType << ") "
-             << title << endl;
+        diagnose(Problem::unknownClass, "(", type, ") (", mType, ")");
     }
 }
 
-void parseGrammar(const string &subsub, const bool print, const string &title,
-                  Dictionary &dict, Dictionary &dictIncom, bool isName,
-                  const string &mType) {
+void parseGrammar(const string_view &subsub, const bool print,
+                  const string_view &title, Dictionary &dict,
+                  FormIndex &forms, bool isName,
+                  const string_view &mType) {
+    const StageTimer timer(Stage::grammar);
 
     if (isName)
-        parseWord(dict, dictIncom, title, "Name", "", "", "", print, mType);
+        parseWord(dict, forms, title, "Name", "", "", "", print, mType);
     else {
-        string grammarField, worttrennung, typeThere, grammatischeMerkmale;
-        for (const auto &field : parseInnerPar(subsub)) {
-
-            const static thread_local vector<string> types = {
-                "Substantiv Übersicht",   "Substantiv Dialekt",
-                "Vorname Übersicht",      "Nachname Übersicht",
-                "Name Übersicht",         "Eigenname Übersicht",
-                "Adjektiv Übersicht",     "Verb Übersicht",
-                "Adverb Übersicht",       "Possessivpronomen",
-                "Demonstrativpronomen",   "Personalpronomen",
-                "Toponym Übersicht",      "Pronomen Übersicht",
-                "adjektivisch Übersicht", "Eigenname",
-                "Pronomina-Tabelle"};
+        string_view grammarField, worttrennung, typeThere,
+            grammatischeMerkmale;
+        static constexpr string_view types[] = {
+            "Substantiv Übersicht",   "Substantiv Dialekt",
+            "Vorname Übersicht",      "Nachname Übersicht",
+            "Name Übersicht",         "Eigenname Übersicht",
+            "Adjektiv Übersicht",     "Verb Übersicht",
+            "Adverb Übersicht",       "Possessivpronomen",
+            "Demonstrativpronomen",   "Personalpronomen",
+            "Toponym Übersicht",      "Pronomen Übersicht",
+            "adjektivisch Übersicht", "Eigenname",
+            "Pronomina-Tabelle"};
+        // The fields most pages have, with the type each contains
+        static constexpr string_view usualFields[] = {
+            "Deutsch Substantiv Übersicht",
+            "Deutsch Substantiv Dialekt",
+            "Deutsch Verb Übersicht",
+            "Deutsch Adjektiv Übersicht",
+            "Deutsch Adverb Übersicht",
+            "Deutsch Toponym Übersicht",
+            "Deutsch Vorname Übersicht m",
+            "Deutsch Vorname Übersicht f",
+            "Deutsch Nachname Übersicht",
+            "Deutsch Name Übersicht",
+            "Deutsch Eigenname Übersicht",
+            "Deutsch adjektivisch Übersicht",
+            "Deutsch Possessivpronomen",
+            "Deutsch Demonstrativpronomen",
+            "Deutsch Personalpronomen 1",
+            "Deutsch Personalpronomen 2",
+            "Deutsch Personalpronomen 3",
+            "Deutsch Pronomen Übersicht",
+            "Pronomina-Tabelle",
+            "Worttrennung",
+            "Aussprache",
+            "Grammatische Merkmale",
+            "Bedeutungen",
+            "Abkürzungen",
+            "Herkunft",
+            "Synonyme",
+            "Sinnverwandte Wörter",
+            "Gegenwörter",
+            "Oberbegriffe",
+            "Unterbegriffe",
+            "Beispiele",
+            "Redewendungen",
+            "Sprichwörter",
+            "Charakteristische Wortkombinationen",
+            "Wortbildungen",
+            "Übersetzungen",
+            "Referenzen",
+            "Quellen",
+            "Ähnlichkeiten",
+            "Alternative Schreibweisen",
+            "Nicht mehr gültige Schreibweisen",
+            "Nebenformen",
+            "Verkleinerungsformen",
+            "Weibliche Wortformen",
+            "Männliche Wortformen",
+            "Koseformen",
+            "Namensvarianten",
+            "Bekannte Namensträger",
+            "Anmerkung",
+            "Entlehnungen",
+            "Holonyme",
+            "Meronyme",
+        };
+        static constexpr auto fieldTypes =
+            containedKeywords(usualFields, types);
 
+        for (const auto &field : parseInnerPar(subsub)) {
             if (grammarField.empty()) {
-                bool found = false;
-                for (const string type : types) {
-                    if (has(get<0>(field), type)) {
-                        found = true;
-                        grammarField = get<0>(field);
-                        typeThere = type;
-                        break;
-                    }
-                }
-                if (found)
+                const size_t *known = fieldTypes.find(get<0>(field));
+                const size_t type =
+                    known ? *known : firstContained(get<0>(field), types);
+                if (type < std::size(types)) {
+                    grammarField = get<0>(field);
+                    typeThere = types[type];
                     continue;
+                }
             }
 
             if (get<0>(field) == "Worttrennung") {
@@ -1040,7 +1104,7 @@ void parseGrammar(const string &subsub, const bool print, const string &title,
 
             if (startsWith(get<0>(field), "Deutsch ") && grammarField.empty()) {
 
-                cout << "Error: unknown field: " << get<0>(field) << endl;
+                diagnose(Problem::unknownField, get<0>(field));
 
             } else {
                 /* if (print)
@@ -1049,241 +1113,891 @@ void parseGrammar(const string &subsub, const bool print, const string &title,
                           << "   " << get<0>(field) << endl;*/
             }
         }
-        parseWord(dict, dictIncom, title, typeThere, grammarField, worttrennung,
+        parseWord(dict, forms, title, typeThere, grammarField, worttrennung,
                   grammatischeMerkmale, print, mType);
     }
 }
 
-void parseSubsections(const string &title, const bool print, Dictionary &dict,
-                      Dictionary &dictIncom, const string &sTitle,
-                      const string &sBody, map<string, size_t> &wordClasses) {
+// Tells from the title of a subsection whether its words are wanted: German
+// ones and names of any language. Counts the word classes on the way.
+static bool wantSubsection(const std::pmr::vector<string_view> &sTitle,
+                           map<string, size_t> &wordClasses, bool &isName,
+                           std::pmr::string &mType) {
+    bool skipSubsection = true;
+    isName = false;
+    for (const string_view fie : sTitle) {
+        auto descrs = leading(fie, Literal("|"), true);
+
+        if (descrs.size() == 3) {
+            const string_view d2 = trim(get<1>(descrs[1]));
+            mType += " ";
+            mType += d2;
+            if (get<1>(descrs[0]) == "Wortart") {
+
+                auto [it, ok] = wordClasses.emplace(d2, 1);
+                if (!ok)
+                    it->second++;
+
+                if (get<1>(descrs[2]) == "Deutsch") {
+                    skipSubsection = false;
+                } else if (d2 == "Vorname" || d2 == "Nachname" ||
+                           d2 == "Name") {
+                    skipSubsection = false;
+                    isName = true;
+                }
+            }
+        }
+    }
+    return !skipSubsection;
+}
+
+// Parses the grammar of a wanted subsection
+static void parseSubsection(const string_view &mTitle, const bool print,
+                            Dictionary &dict, FormIndex &forms,
+                            const string_view &body, bool isName,
+                            const string_view &mType) {
+    const Diagnosing diagnosing(mTitle);
+    // Split into subsubsections
+    for (const auto &subsubsection :
+         leading(body, HeadingMatcher("==== {{", "}} ====\n"), true)) {
+
+        // Iterate the subsubsection title
+        const std::pmr::vector<string_view> ssTitle =
+            parseSectionTitle(get<0>(subsubsection));
+        /*if (print) {
+            cout << "      ";
+            for (const string descr : ssTitle) {
+                cout << descr << " ";
+            }
+            cout << endl;
+        }*/
+
+        if (only(ssTitle, "")) {
+            parseGrammar(get<1>(subsubsection), print, mTitle, dict,
+                         forms, isName, mType);
+        }
+    }
+}
+
+void parseSubsections(const string_view &title, const bool print,
+                      Dictionary &dict, FormIndex &forms,
+                      const string_view &sTitle, const string_view &sBody,
+                      map<string, size_t> &wordClasses) {
     // Iterate the section title
-    const string mTitle = trim(title);
-    const vector<string> titleP = parseSectionTitle(sTitle);
+    const string_view mTitle = trim(title);
+    const std::pmr::vector<string_view> titleP = parseSectionTitle(sTitle);
     if (print) {
         cout << mTitle << " ";
-        for (const string descr : titleP) {
+        for (const string_view descr : titleP) {
             cout << descr << " ";
         }
         cout << endl;
     }
 
     // Split into subsections
-    const static thread_local std::regex reSubSec(
-        R"(=== \{\{(([^\}]|\}\}, \{\{)*)\}\} ===\n)");
-    for (const auto &subsection : leading<1>(sBody, reSubSec)) {
+    for (const auto &subsection :
+         leading(sBody, HeadingMatcher("=== {{", "}} ===\n"))) {
 
         // Iterate the subsection title // TODO: Extract ===
         // {{Wortart|Reziprokpronomen|Deutsch}} ===
-        vector<string> sTitle = parseSectionTitle(get<0>(subsection));
+        const std::pmr::vector<string_view> sTitle =
+            parseSectionTitle(get<0>(subsection));
         if (print) {
             cout << "   ";
-            for (const string descr : sTitle) {
+            for (const string_view descr : sTitle) {
                 cout << descr << " ";
             }
             cout << endl;
         }
 
         // Check if we are interested in such a word
-        const static thread_local std::regex vert(
-            R"(\|)");
-        bool skipSubsection = true;
-        bool isName = false;
-        string mType;
-        for (const string fie : sTitle) {
-            auto descrs = leading<0>(fie, vert, true);
-
-            if (descrs.size() == 3) {
-                const string d2 = trim(get<1>(descrs[1]));
-                mType += " " + d2;
-                if (get<1>(descrs[0]) == "Wortart") {
-
-                    auto [it, ok] = wordClasses.emplace(d2, 1);
-                    if (!ok)
-                        it->second++;
-
-                    if (get<1>(descrs[2]) == "Deutsch") {
-                        skipSubsection = false;
-                    } else if (d2 == "Vorname" || d2 == "Nachname" ||
-                               d2 == "Name") {
-                        skipSubsection = false;
-                        isName = true;
-                    }
-                }
-            }
-        }
-        if (skipSubsection)
+        bool isName;
+        std::pmr::string mType(scratch());
+        if (!wantSubsection(sTitle, wordClasses, isName, mType))
             continue;
 
-        // Split into subsubsections
-        const static thread_local std::regex reSubSubSec(
-            R"(==== \{\{(([^\}]|\}\}, \{\{)*)\}\} ====\n)");
-        for (const auto &subsubsection :
-             leading<1>(get<1>(subsection), reSubSubSec, true)) {
-
-            // Iterate the subsubsection title
-            vector<string> ssTitle = parseSectionTitle(get<0>(subsubsection));
-            /*if (print) {
-                cout << "      ";
-                for (const string descr : ssTitle) {
-                    cout << descr << " ";
-                }
-                cout << endl;
-            }*/
-
-            if (only(ssTitle, "")) {
-                parseGrammar(get<1>(subsubsection), print, mTitle, dict,
-                             dictIncom, isName, mType);
-            }
-        }
+        parseSubsection(mTitle, print, dict, forms, get<1>(subsection),
+                        isName, mType);
     }
 }
 
+const vector<string> &parseWiki::mergeKey(const Noun &n) {
+    return n.nominative.singular;
+}
+const vector<string> &parseWiki::mergeKey(const Adjective &a) {
+    return a.positive;
+}
+const vector<string> &parseWiki::mergeKey(const Pronoun &p) {
+    return p.nominative.singular;
+}
+const vector<string> &parseWiki::mergeKey(const Verb &v) {
+    return v.base.presentInfinitive;
+}
+
+// Merges every form of source into the first entry of container doMerge
+// accepts. doMerge only accepts entries that share the lemma, or the form if
+// it is a key, with the forms mergeKey returns, so only those are tried.
+// Merging may add forms, the index keeps up.
 template <typename T, typename F>
-inline void merge(vector<T> &container, const vector<T> &source, size_t &merged,
-                  size_t &tryMerge, F doMerge) {
-    auto it = source.begin();
-    while (it != source.end()) {
-        const T &test = *it;
-        bool matched = false;
+inline void merge(vector<T> &container, const vector<InflectedForm> &source,
+                  size_t &merged, size_t &tryMerge, F doMerge) {
+    // Positions in container by form, ascending
+    std::unordered_map<string, vector<size_t>> index;
+    auto add = [&](size_t at, const string &form) {
+        vector<size_t> &positions = index[form];
+        auto it = std::lower_bound(positions.begin(), positions.end(), at);
+        if (it == positions.end() || *it != at)
+            positions.insert(it, at);
+    };
+    for (size_t at = 0; at < container.size(); at++)
+        for (const string &form : mergeKey(container[at]))
+            add(at, form);
+
+    vector<size_t> candidates;
+    auto lookUp = [&](const string &form) {
+        auto found = index.find(form);
+        if (found != index.end())
+            candidates.insert(candidates.end(), found->second.begin(),
+                              found->second.end());
+    };
+    for (const InflectedForm &test : source) {
         tryMerge++;
-        for (auto i = container.begin(); i != container.end(); i++) {
-            if (i != it && doMerge(*i, test)) {
-                matched = true;
-                // cout << "merged " << test.nominative.singular[0] <<
-                // endl;
+        candidates.clear();
+        lookUp(test.lemma);
+        if (test.formIsKey)
+            lookUp(test.form);
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                         candidates.end());
+
+        for (const size_t at : candidates) {
+            const size_t known = mergeKey(container[at]).size();
+            if (doMerge(container[at], test)) {
                 merged++;
+                const vector<string> &forms = mergeKey(container[at]);
+                for (size_t f = known; f < forms.size(); f++)
+                    add(at, forms[f]);
                 break;
             }
         }
-        /* if (!matched)
-             cout << "Error: Couldn't merge "
-                  << test.nominative.singular[0] << endl;*/
-
-        it++;
     }
 }
 
-static inline void pushUnique(Numeri &a, const Numeri &b) {
-    pushUnique(a.singular, b.singular);
-    pushUnique(a.plural, b.plural);
+static inline bool contains(const vector<string> &forms, const string &form) {
+    return std::find(forms.begin(), forms.end(), form) != forms.end();
 }
-static inline void pushUnique(WithCases &a, const WithCases &b) {
-    for (size_t k = 0; k < 4; k++) {
-        pushUnique(a.cases[k], b.cases[k]);
+
+// Adds forms to the lists of entries while they are merged, without
+// duplicates and in the order they come. Short lists are searched. A list
+// that grows longer gets a hash set of its forms, so merging many forms into
+// it isn't quadratic. The set holds views of the strings of the list, so it
+// is built again when the list has moved or was changed elsewhere.
+class FormAdder {
+  private:
+    static const size_t searched = 64;
+
+    struct Seen {
+        const string *data = nullptr;
+        size_t size = 0;
+        std::unordered_set<string_view> forms;
+    };
+    std::unordered_map<const vector<string> *, Seen> lists;
+
+  public:
+    void add(vector<string> &forms, const string &form);
+
+    // Adds the form to the cases of c its bits name
+    void add(WithCases &c, const string &form, uint32_t slots) {
+        for (size_t k = 0; k < 4; k++) {
+            if (slots & (uint32_t(1) << 2 * k))
+                add(c.cases[k].singular, form);
+            if (slots & (uint32_t(1) << (2 * k + 1)))
+                add(c.cases[k].plural, form);
+        }
+    }
+};
+
+void FormAdder::add(vector<string> &forms, const string &form) {
+    if (forms.size() < searched) {
+        if (!contains(forms, form))
+            forms.push_back(form);
+        return;
+    }
+    Seen &seen = lists[&forms];
+    if (seen.data != forms.data() || seen.size != forms.size()) {
+        seen.forms.clear();
+        seen.forms.insert(forms.begin(), forms.end());
+        seen.data = forms.data();
+        seen.size = forms.size();
+    }
+    if (seen.forms.count(form))
+        return;
+    forms.push_back(form);
+    // If the strings moved, the next call builds the set again
+    if (forms.data() == seen.data) {
+        seen.forms.insert(forms.back());
+        seen.size++;
     }
 }
-static inline void pushUnique(Person &a, const Person &b) {
-    pushUnique(a.first, b.first);
-    pushUnique(a.second, b.second);
-    pushUnique(a.third, b.third);    
+
+// Whether the nominative singular has a form test is merged by
+static inline bool hasKey(const vector<string> &nominative,
+                          const InflectedForm &test) {
+    return contains(nominative, test.lemma) ||
+           (test.formIsKey && contains(nominative, test.form));
 }
 
-void mergeDict(Dictionary &dict, Dictionary &dictIncom) {
-    cout << endl << "merging..." << endl;
-    size_t merged = 0, tryMerge = 0;
-
-        merge(dict.nouns, dictIncom.nouns, merged, tryMerge,
-              [](Noun &i, const Noun &test) {
-                  if (!(i.genus <= test.genus) || i.type != NounType::Noun ||
-                      !doIntersect(i.nominative.singular,
-       test.nominative.singular)) return false; pushUnique(i, test); return
-       true;
-              });
-
-        merge(dict.adjectives, dictIncom.adjectives, merged, tryMerge,
-              [](Adjective &i, const Adjective &test) {
-                  if (!doIntersect(i.positive, test.positive))
-                      return false;
-                  for (size_t j = 0; j < 9; j++) {
-                      pushUnique(i.cases[j],
-                                     test.cases[j]);
-                         
-
-                  }
-                  pushUnique(i.positive, test.positive);
-                  pushUnique(i.superlative, test.superlative);
-                  pushUnique(i.comparative, test.comparative);
-
-                  return true;
-              });
-        merge(dict.pronouns, dictIncom.pronouns, merged, tryMerge,
-              [](Pronoun &i, const Pronoun &test) {
-                  if (i.type != test.type ||
-                      !doIntersect(i.nominative.singular,
-       test.nominative.singular)) return false; pushUnique(i, test); return
-       true;
-              });
-              
-    merge(dict.verbs, dictIncom.verbs, merged, tryMerge,
-          [](Verb &i, const Verb &test) {
-              if (!doIntersect(i.base.presentInfinitive,
-                               test.base.presentInfinitive))
+void parseWiki::mergeForms(vector<Noun> &into,
+                           const vector<InflectedForm> &from, size_t &merged,
+                           size_t &tryMerge) {
+    FormAdder adder;
+    merge(into, from, merged, tryMerge,
+          [&adder](Noun &i, const InflectedForm &test) {
+              // Forms have no genus, which fits every genus
+              if (i.type != NounType::Noun ||
+                  !hasKey(i.nominative.singular, test))
                   return false;
-              pushUnique(i.imperative, test.imperative);
-              pushUnique(i.base.auxiliary, test.base.auxiliary);
-              pushUnique(i.base.irrealis_firstSingular,
-                         test.base.irrealis_firstSingular);
-              pushUnique(i.base.participleII, test.base.participleII);
-              pushUnique(i.base.present, test.base.present);
-              pushUnique(i.base.presentInfinitive, test.base.presentInfinitive);
-              pushUnique(i.base.preterite_firstSingular,
-                         test.base.preterite_firstSingular);
-              pushUnique(i.base.subjunctive_firstSingular,
-                         test.base.subjunctive_firstSingular);
+              adder.add(i.nominative.singular, test.lemma);
+              adder.add(i, test.form, test.slots);
+              return true;
+          });
+}
 
+void parseWiki::mergeForms(vector<Adjective> &into,
+                           const vector<InflectedForm> &from, size_t &merged,
+                           size_t &tryMerge) {
+    FormAdder adder;
+    merge(into, from, merged, tryMerge,
+          [&adder](Adjective &i, const InflectedForm &test) {
+              if (!contains(i.positive, test.lemma))
+                  return false;
+              for (size_t genus = 0; genus < 3; genus++)
+                  adder.add(i.cases[test.detail * 3 + genus], test.form,
+                            (test.slots >> 8 * genus) & 0xff);
               return true;
           });
+}
 
-    cout << endl << "merged " << merged << " of " << tryMerge << endl;
+void parseWiki::mergeForms(vector<Pronoun> &into,
+                           const vector<InflectedForm> &from, size_t &merged,
+                           size_t &tryMerge) {
+    FormAdder adder;
+    merge(into, from, merged, tryMerge,
+          [&adder](Pronoun &i, const InflectedForm &test) {
+              if (i.type != pronounType(test.detail) ||
+                  !hasKey(i.nominative.singular, test))
+                  return false;
+              adder.add(i.nominative.singular, test.lemma);
+              adder.add(i, test.form, test.slots);
+              return true;
+          });
 }
 
-namespace parseWiki {
+void parseWiki::mergeForms(vector<Verb> &into,
+                           const vector<InflectedForm> &from, size_t &merged,
+                           size_t &tryMerge) {
+    FormAdder adder;
+    merge(into, from, merged, tryMerge,
+          [&adder](Verb &i, const InflectedForm &test) {
+              if (!contains(i.base.presentInfinitive, test.lemma))
+                  return false;
+              for (size_t slot = 0; slot < verbSlots; slot++)
+                  if (test.slots & (uint32_t(1) << slot))
+                      adder.add(verbSlot(i, slot), test.form);
+              return true;
+          });
+}
 
-Dictionary parseWiki(shared_ptr<istream> &&in) {
-    const bool print = false;
+// The word classes don't depend on each other, so each is merged on its own
+// thread of the pool. Within a class the order matters.
+void parseWiki::mergeDict(Dictionary &dict, const FormIndex &forms,
+                          ThreadPool &pool) {
+    cout << endl << "merging..." << endl;
+    size_t merged[4] = {}, tryMerge[4] = {};
+
+    pool.add([&]() {
+        const StageTimer timer(Stage::mergeNouns);
+        mergeForms(dict.nouns, forms.nouns, merged[0], tryMerge[0]);
+    });
+    pool.add([&]() {
+        const StageTimer timer(Stage::mergeAdjectives);
+        mergeForms(dict.adjectives, forms.adjectives, merged[1],
+                   tryMerge[1]);
+    });
+    pool.add([&]() {
+        const StageTimer timer(Stage::mergePronouns);
+        mergeForms(dict.pronouns, forms.pronouns, merged[2], tryMerge[2]);
+    });
+    pool.add([&]() {
+        const StageTimer timer(Stage::mergeVerbs);
+        mergeForms(dict.verbs, forms.verbs, merged[3], tryMerge[3]);
+    });
+
+    pool.wait();
+    cout << endl
+         << "merged " << merged[0] + merged[1] + merged[2] + merged[3]
+         << " of " << tryMerge[0] + tryMerge[1] + tryMerge[2] + tryMerge[3]
+         << endl;
+}
+
+// Copies of consecutive pages, so the reader can continue while they are parsed
+struct PageBatch {
+    size_t seq;
+    string data;
+    vector<size_t> ends;
+    size_t pages = 0, end = 0; // As in PageShard
+
+    void add(const string_view &page) {
+        data.append(page);
+        ends.push_back(data.size());
+    }
+
+    template <typename F> void forEach(F f) const {
+        size_t start = 0;
+        for (const size_t end : ends) {
+            f(string_view(data).substr(start, end - start));
+            start = end;
+        }
+    }
+};
+
+void parsePage(const string_view &page, const bool print, Dictionary &dict,
+               FormIndex &forms, map<string, size_t> &wordClasses) {
+    const StageTimer timer(Stage::parse);
+    const string_view title = tagContent(page, "title");
+
+    // Split into sections separated by == Title {{Sprache:lang}} ==. Every
+    // language is looked at, names are taken from all of them.
+    StageTimer splitting(Stage::split);
+    const Parts sections = leading(textContent(page), SectionMatcher());
+    splitting.stop();
+    for (const auto &section : sections)
+        parseSubsections(title, print, dict, forms, get<0>(section),
+                         get<1>(section), wordClasses);
+}
+
+// Writes the subsections of the page parseSubsections would parse to out
+static void extractPage(const string_view &page,
+                        map<string, size_t> &wordClasses, SectionWriter &out) {
+    const StageTimer timer(Stage::parse);
+    Section wanted;
+    wanted.title = trim(tagContent(page, "title"));
+
+    StageTimer splitting(Stage::split);
+    const Parts sections = leading(textContent(page), SectionMatcher());
+    splitting.stop();
+    for (const auto &section : sections) {
+        wanted.section = get<0>(section);
+        for (const auto &subsection : leading(
+                 get<1>(section), HeadingMatcher("=== {{", "}} ===\n"))) {
+            bool isName;
+            std::pmr::string mType(scratch());
+            if (!wantSubsection(parseSectionTitle(get<0>(subsection)),
+                                wordClasses, isName, mType))
+                continue;
+            wanted.heading = get<0>(subsection);
+            wanted.body = get<1>(subsection);
+            out.add(wanted);
+        }
+    }
+}
+
+// Parses the page into shard. With a store, pages it has in the same revision
+// are copied from it instead and every page is recorded for the next run.
+void takePage(const string_view &page, const bool print,
+              const PageStore *store, PageShard &shard) {
+    if (!store) {
+        parsePage(page, print, shard.dict, shard.forms,
+                  shard.wordClasses);
+        return;
+    }
+
+    PageRecord record;
+    if (pageRevision(page, record.id, record.revision)) {
+        const size_t known = store->unchanged(record.id, record.revision);
+        if (known != PageStore::npos) {
+            store->copyTo(known, shard);
+            stats().addReused();
+            return;
+        }
+    } else {
+        record.id = record.revision = 0;
+    }
 
-    Dictionary dict;
-    Dictionary dictIncom;
-    bool keepParsing = true;
     map<string, size_t> wordClasses;
+    record.begin(shard.dict, shard.forms);
+    parsePage(page, print, shard.dict, shard.forms, wordClasses);
+    record.end(shard.dict, shard.forms);
+    for (const auto &wc : wordClasses) {
+        shard.wordClasses[wc.first] += wc.second;
+        record.wordClasses.push_back(wc);
+    }
+    shard.records.push_back(std::move(record));
+}
 
-    while (keepParsing) {
-        const string page = readTag(in, "page");
-        if (page == "\0")
-            break;
+// One thread reads and batches the pages, the workers parse every batch into
+// its own shard and the calling thread appends the shards in the order of the
+// dump. So the result is the same as when parsing on a single thread.
+// progress is called after every shard.
+template <typename F>
+void parsePipelined(PageReader &reader, const PageFilter &filter,
+                    const PageStore *store, const bool print, size_t threads,
+                    PageShard &all, F progress) {
+    const size_t batchSize = 256;
+    const size_t maxInFlight = 4 * threads;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<PageBatch> todo;
+    map<size_t, PageShard> done;
+    size_t batches = 0, merged = 0;
+    bool finished = false;
+    std::exception_ptr error;
+
+    vector<std::thread> workers;
+    for (size_t i = 0; i < threads; i++) {
+        workers.emplace_back([&]() {
+            PageArena arena;
+            while (true) {
+                PageBatch batch;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait(lock,
+                                 [&]() { return !todo.empty() || finished; });
+                    if (todo.empty())
+                        return;
+                    batch = std::move(todo.front());
+                    todo.pop_front();
+                }
+                PageShard shard;
+                shard.pages = batch.pages;
+                shard.end = batch.end;
+                try {
+                    batch.forEach([&](const string_view &page) {
+                        takePage(page, print, store, shard);
+                        arena.reset();
+                    });
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error)
+                        error = std::current_exception();
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    done.emplace(batch.seq, std::move(shard));
+                }
+                changed.notify_all();
+            }
+        });
+    }
 
-        // Split into sections separated by == Title {{Sprache:lang}} ==
-        const static thread_local std::regex innerText(
-            R"(<text( [^>]*)?>([^<]*)</text>)");
-        const static thread_local std::regex reSec(
-            R"(== [^\(]+ \(\{\{Sprache\|([^\}]+)\}\}\) ==\n)");
-        for (const auto &section :
-             leading<1>(match<2>(page, innerText), reSec)) {
-            const string title = readTag(page, "title");
-            if (get<0>(section) == "Deutsch") {
-                parseSubsections(title, print, dict, dictIncom, get<0>(section),
-                                 get<1>(section), wordClasses);
+    std::thread producer([&]() {
+        PageBatch batch;
+        string_view page;
+        bool more = true;
+        while (more) {
+            try {
+                more = reader.nextPage(page);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error)
+                    error = std::current_exception();
+                break;
+            }
+            if (more) {
+                if (filter.accepts(page))
+                    batch.add(page);
+                batch.pages++;
+                batch.end = reader.offset();
+            }
+            if (batch.ends.size() < batchSize && more)
+                continue;
 
-            } else {
-                parseSubsections(title, print, dict, dictIncom, get<0>(section),
-                                 get<1>(section), wordClasses);
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock,
+                         [&]() { return batches - merged < maxInFlight; });
+            if (error)
+                break;
+            if (batch.pages > 0) {
+                batch.seq = batches++;
+                todo.push_back(std::move(batch));
+                batch = PageBatch();
             }
+            lock.unlock();
+            changed.notify_all();
         }
-        if (dict.size() > 10000) {
-           // keepParsing = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished = true;
+        }
+        changed.notify_all();
+    });
+
+    while (true) {
+        PageShard shard;
+        bool failed;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&]() {
+                return done.count(merged) || (finished && merged == batches);
+            });
+            auto it = done.find(merged);
+            if (it == done.end())
+                break;
+            shard = std::move(it->second);
+            done.erase(it);
+            merged++;
+            failed = bool(error);
+        }
+        changed.notify_all();
+        all.append(std::move(shard));
+
+        // Never save a state with a batch missing. Keep merging after an error
+        // until the reader has noticed it.
+        if (failed)
+            continue;
+        try {
+            progress();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error)
+                error = std::current_exception();
+        }
+    }
+
+    producer.join();
+    for (auto &worker : workers)
+        worker.join();
+    if (error)
+        std::rethrow_exception(error);
+}
+
+// Parses the remaining pages into all, saving checkpoints on the way. locate
+// turns an input offset into a ResumePoint.
+template <typename L>
+void parsePages(PageReader &reader, size_t threads, const PageFilter &filter,
+                const PageStore *store, SpillRuns *runs,
+                const Checkpointing &checkpoints, size_t source, L locate,
+                ProgressMeter &meter, PageShard &all) {
+    const bool print = false;
+
+    size_t saved = all.pages;
+    auto progress = [&]() {
+        meter.update(all.pages, all.end);
+        if (runs)
+            runs->check(all.dict, all.forms);
+        if (checkpoints.path.empty() ||
+            all.pages - saved < checkpoints.everyPages)
+            return;
+        Checkpoint cp;
+        cp.source = source;
+        cp.pages = all.pages;
+        cp.at = locate(all.end);
+        cp.runs = runs ? runs->count() : 0;
+        saveCheckpoint(checkpoints.path, cp, all);
+        saved = all.pages;
+        cout << endl << "Checkpoint after " << all.pages << " pages" << endl;
+    };
+
+    if (threads > 1) {
+        parsePipelined(reader, filter, store, print, threads, all, progress);
+    } else {
+        PageArena arena;
+        string_view page;
+        while (reader.nextPage(page)) {
+            if (filter.accepts(page)) {
+                takePage(page, print, store, all);
+                arena.reset();
+            }
+            all.pages++;
+            all.end = reader.offset();
+            progress();
         }
     }
+    meter.finish(all.pages, all.end);
 
     if (print) {
-        cout << endl << wordClasses.size() << " word classes" << endl;
-        for (const auto &wc : wordClasses)
+        cout << endl << all.wordClasses.size() << " word classes" << endl;
+        for (const auto &wc : all.wordClasses)
             cout << wc.second << " " << wc.first << endl;
     }
+}
 
-    mergeDict(dict, dictIncom);
+// Writes the wanted subsections of the remaining pages to out
+static void extractPages(PageReader &reader, const PageFilter &filter,
+                         ProgressMeter &meter, SectionWriter &out) {
+    PageArena arena;
+    map<string, size_t> wordClasses;
+    string_view page;
+    size_t pages = 0;
+    while (reader.nextPage(page)) {
+        if (filter.accepts(page)) {
+            extractPage(page, wordClasses, out);
+            arena.reset();
+        }
+        pages++;
+        meter.update(pages, reader.offset());
+    }
+    meter.finish(pages, reader.offset());
+    out.finish();
+    cout << out.size() << " subsections of " << pages << " pages extracted"
+         << endl;
+}
+
+// Parses the subsections [begin, end) of the file into shard
+static void parseSectionRange(const SectionFile &sections, size_t begin,
+                              size_t end, PageShard &shard) {
+    const bool print = false;
+    PageArena arena;
+    for (size_t i = begin; i < end; i++) {
+        {
+            const StageTimer timer(Stage::parse);
+            const Section section = sections[i];
+            bool isName;
+            std::pmr::string mType(scratch());
+            wantSubsection(parseSectionTitle(section.heading),
+                           shard.wordClasses, isName, mType);
+            parseSubsection(section.title, print, shard.dict,
+                            shard.forms, section.body, isName, mType);
+        }
+        arena.reset();
+    }
+}
+
+// Picks up an earlier run if there is a checkpoint for it
+static Checkpoint resume(const Checkpointing &checkpoints, size_t source,
+                         SpillRuns *runs, PageShard &all) {
+    Checkpoint cp;
+    if (checkpoints.path.empty() ||
+        !loadCheckpoint(checkpoints.path, cp, all))
+        cp = Checkpoint();
+    if (runs)
+        runs->resume(cp.runs);
+    if (cp.pages == 0)
+        return cp;
+    if (cp.source != source)
+        throw Exception(checkpoints.path + " belongs to another dump");
+    all.pages = cp.pages;
+    all.end = cp.at.offset;
+    cout << "Resuming after " << cp.pages << " pages" << endl;
+    return cp;
+}
+
+// The pages of the last run, or nullptr if no path is given. A missing file
+// leaves the store empty, so every page is parsed.
+static std::unique_ptr<PageStore> openStore(const string &path) {
+    if (path.empty())
+        return nullptr;
+    auto store = std::make_unique<PageStore>();
+    if (store->load(path))
+        cout << "Reusing unchanged pages from " << path << endl;
+    return store;
+}
+
+// Size of what is left in the stream or 0 if it can't tell
+static size_t streamSize(istream &in) {
+    const std::streampos here = in.tellg();
+    if (here == std::streampos(-1))
+        return 0;
+    in.seekg(0, std::ios::end);
+    const std::streampos end = in.tellg();
+    in.clear();
+    in.seekg(here);
+    return end == std::streampos(-1) ? 0 : size_t(end - here);
+}
+
+static size_t threadCount(size_t threads) {
+    if (threads == 0)
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    return threads;
+}
+
+// Parses the pages of in into all, continuing after a checkpoint
+static void parseStream(shared_ptr<istream> &&in, size_t threads,
+                        const PageFilter &filter,
+                        const Checkpointing &checkpoints,
+                        const PageStore *store, SpillRuns *runs,
+                        PageShard &all) {
+    const Checkpoint from = resume(checkpoints, 0, runs, all);
+    const size_t total = streamSize(*in);
+    if (from.at.offset > 0) {
+        // Skip what has been parsed already, by reading it if need be
+        in->seekg(from.at.offset);
+        if (!*in) {
+            in->clear();
+            in->ignore(from.at.offset);
+        }
+    }
+
+    ProgressMeter meter(total, [](size_t offset) { return offset; }, all.pages,
+                        all.end, all.end);
+    PageReader reader(in, 16 * 1024 * 1024, from.at.offset);
+    parsePages(reader, threads, filter, store, runs, checkpoints, 0,
+               [](size_t offset) {
+                   ResumePoint at;
+                   at.offset = offset;
+                   return at;
+               },
+               meter, all);
+}
+
+// Parses the pages of the multistream dump into all, continuing after a
+// checkpoint
+static void parseDump(const string &dump, const string &index, size_t threads,
+                      const PageFilter &filter,
+                      const Checkpointing &checkpoints,
+                      const PageStore *store, SpillRuns *runs,
+                      PageShard &all) {
+    size_t source;
+    {
+        std::ifstream file(dump, std::ios::binary | std::ios::ate);
+        if (!file.good())
+            throw Exception("Can't open " + dump);
+        source = file.tellg();
+    }
+    const Checkpoint from = resume(checkpoints, source, runs, all);
+
+    auto in = make_shared<MultistreamIn>(dump, index, threads, from.at);
+    // The streams in front of the one being read tell how far we are
+    ProgressMeter meter(
+        source, [&](size_t offset) { return in->locate(offset).stream; },
+        all.pages, all.end, from.at.stream);
+    PageReader reader(in, 16 * 1024 * 1024, from.at.offset);
+    parsePages(reader, threads, filter, store, runs, checkpoints, source,
+               [&](size_t offset) { return in->locate(offset); }, meter,
+               all);
+}
+
+// Saves what all pages contributed and merges the entries
+static Dictionary finish(PageShard &all, size_t threads,
+                         const Checkpointing &checkpoints,
+                         const string &pages) {
+    if (!pages.empty())
+        savePages(pages, all);
+    {
+        const StageTimer timer(Stage::mergeDict);
+        ThreadPool pool(std::min<size_t>(threads, 4));
+        mergeDict(all.dict, all.forms, pool);
+    }
+    if (!checkpoints.path.empty())
+        removeCheckpoint(checkpoints.path);
+    return std::move(all.dict);
+}
+
+// Merges the runs into out. The checkpoint goes first, it needs the runs.
+// If merging fails they are deleted too, unless a checkpoint can resume with
+// them.
+static void finish(PageShard &all, SpillRuns &runs,
+                   const Checkpointing &checkpoints, ostream &out) {
+    try {
+        runs.finish(all.dict, all.forms, out);
+    } catch (...) {
+        if (checkpoints.path.empty())
+            runs.remove();
+        throw;
+    }
+    if (!checkpoints.path.empty())
+        removeCheckpoint(checkpoints.path);
+    runs.remove();
+}
+
+namespace parseWiki {
+
+Dictionary parseWiki(shared_ptr<istream> &&in, size_t threads,
+                     const PageFilter &filter,
+                     const Checkpointing &checkpoints, const string &pages) {
+    threads = threadCount(threads);
+    const auto store = openStore(pages);
+    PageShard all;
+    parseStream(std::move(in), threads, filter, checkpoints, store.get(),
+                nullptr, all);
+    return finish(all, threads, checkpoints, pages);
+}
+
+Dictionary parseWiki(const string &dump, const string &index, size_t threads,
+                     const PageFilter &filter,
+                     const Checkpointing &checkpoints, const string &pages) {
+    threads = threadCount(threads);
+    const auto store = openStore(pages);
+    PageShard all;
+    parseDump(dump, index, threads, filter, checkpoints, store.get(), nullptr,
+              all);
+    return finish(all, threads, checkpoints, pages);
+}
+
+void extractSections(shared_ptr<istream> &&in, const string &path,
+                     const PageFilter &filter) {
+    SectionWriter out(path);
+    ProgressMeter meter(streamSize(*in), [](size_t offset) { return offset; },
+                        0, 0, 0);
+    PageReader reader(in, 16 * 1024 * 1024);
+    extractPages(reader, filter, meter, out);
+}
+
+void extractSections(const string &dump, const string &index,
+                     const string &path, size_t threads,
+                     const PageFilter &filter) {
+    size_t source;
+    {
+        std::ifstream file(dump, std::ios::binary | std::ios::ate);
+        if (!file.good())
+            throw Exception("Can't open " + dump);
+        source = file.tellg();
+    }
+    SectionWriter out(path);
+    auto in = make_shared<MultistreamIn>(dump, index, threadCount(threads),
+                                         ResumePoint());
+    ProgressMeter meter(
+        source, [&](size_t offset) { return in->locate(offset).stream; }, 0,
+        0, 0);
+    PageReader reader(in, 16 * 1024 * 1024);
+    extractPages(reader, filter, meter, out);
+}
+
+Dictionary parseSections(const string &path, size_t threads) {
+    threads = threadCount(threads);
+    const SectionFile sections(path);
+
+    // Consecutive chunks appended in order, as in parsePipelined
+    const size_t chunks = std::min(sections.size(), 4 * threads);
+    vector<PageShard> shards(chunks);
+    ThreadPool pool(threads);
+    for (size_t c = 0; c < chunks; c++)
+        pool.add([&, c]() {
+            parseSectionRange(sections, sections.size() * c / chunks,
+                              sections.size() * (c + 1) / chunks, shards[c]);
+        });
+    pool.wait();
+
+    PageShard all;
+    for (PageShard &shard : shards)
+        all.append(std::move(shard));
+    {
+        const StageTimer timer(Stage::mergeDict);
+        mergeDict(all.dict, all.forms, pool);
+    }
+    return std::move(all.dict);
+}
+
+void parseWiki(ostream &out, shared_ptr<istream> &&in, size_t threads,
+               const PageFilter &filter, const Checkpointing &checkpoints,
+               const Spilling &spilling) {
+    threads = threadCount(threads);
+    SpillRuns runs(spilling);
+    PageShard all;
+    parseStream(std::move(in), threads, filter, checkpoints, nullptr, &runs,
+                all);
+    finish(all, runs, checkpoints, out);
+}
 
-    return dict;
+void parseWiki(ostream &out, const string &dump, const string &index,
+               size_t threads, const PageFilter &filter,
+               const Checkpointing &checkpoints, const Spilling &spilling) {
+    threads = threadCount(threads);
+    SpillRuns runs(spilling);
+    PageShard all;
+    parseDump(dump, index, threads, filter, checkpoints, nullptr, &runs, all);
+    finish(all, runs, checkpoints, out);
 }
 
-} // namespace parseWiki
\ No newline at end of file
+} // namespace parseWiki
@@ -3,10 +3,60 @@
 #include <memory>
 using std::shared_ptr, std::make_shared;
 
+#include "checkpoint.hpp"
 #include "dictionary.hpp"
+#include "spill.hpp"
+#include "wikiReader.hpp"
 
 namespace parseWiki {
 
-Dictionary parseWiki(shared_ptr<istream> &&in);
+// Parses the pages of the dump on the given number of threads (0 for one per
+// core). Pages the filter rejects are skipped before they are parsed. With a
+// checkpoint path, the progress is saved every so many pages and a later run
+// continues where the last checkpoint was taken.
+//
+// With a pages path, what every page contributed is saved there by page id and
+// revision. The next run copies the pages that didn't change from it and only
+// parses the new and edited ones. The result is the same as parsing everything,
+// as long as the parser and the filter are the same; delete the file after
+// changing either.
+Dictionary parseWiki(shared_ptr<istream> &&in, size_t threads = 0,
+                     const PageFilter &filter = PageFilter(),
+                     const Checkpointing &checkpoints = Checkpointing(),
+                     const string &pages = "");
+
+// Parses a bz2 "multistream" dump without decompressing it to disk. The
+// streams are decompressed in parallel using the offsets from the index file.
+// A resumed run starts decompressing at the stream of its checkpoint.
+Dictionary parseWiki(const string &dump, const string &index,
+                     size_t threads = 0,
+                     const PageFilter &filter = PageFilter(),
+                     const Checkpointing &checkpoints = Checkpointing(),
+                     const string &pages = "");
+
+// The same with bounded memory: once the parsed entries take more than the
+// budget, they are moved to run files and the runs are merged at the end. The
+// simplified dictionary is written to out the way Dictionary::serialize does.
+// The budget only covers the entries parsed so far, not the pages in flight
+// or the merge indexes.
+void parseWiki(ostream &out, shared_ptr<istream> &&in, size_t threads,
+               const PageFilter &filter, const Checkpointing &checkpoints,
+               const Spilling &spilling);
+void parseWiki(ostream &out, const string &dump, const string &index,
+               size_t threads, const PageFilter &filter,
+               const Checkpointing &checkpoints, const Spilling &spilling);
+
+// A run in two phases, for when the rules of the grammar parsers change more
+// often than the dump. extractSections reads the dump once and writes the
+// subsections the parsers look at, German words and names of all languages,
+// to a section file (see sectionFile.hpp). parseSections parses only that file
+// and gives the same as parseWiki on the dump with the same filter. Extract
+// again after changing which subsections are wanted.
+void extractSections(shared_ptr<istream> &&in, const string &path,
+                     const PageFilter &filter = PageFilter());
+void extractSections(const string &dump, const string &index,
+                     const string &path, size_t threads = 0,
+                     const PageFilter &filter = PageFilter());
+Dictionary parseSections(const string &path, size_t threads = 0);
 
 } // namespace parseWiki
\ No newline at end of file
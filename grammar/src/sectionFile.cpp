@@ -0,0 +1,97 @@
+#include "sectionFile.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "binaryIO.hpp"
+#include "util.hpp"
+
+namespace parseWiki {
+
+static const char magic[8] = {'P', 'W', 'S', 'E', 'C', 'T', '0', '1'};
+static const size_t headerSize = sizeof(magic) + 2 * sizeof(uint64_t);
+
+SectionWriter::SectionWriter(const string &path)
+    : path(path), out(path + ".tmp", std::ios::binary | std::ios::trunc),
+      at(headerSize) {
+    if (!out.good())
+        throw Exception("Can't write " + path + ".tmp");
+    // The numbers are filled in by finish
+    out.write(magic, sizeof(magic));
+    writeBinary(out, uint64_t(0));
+    writeBinary(out, uint64_t(0));
+}
+
+void SectionWriter::put(const string_view &text) {
+    index.push_back(at);
+    out.write(text.data(), text.size());
+    at += text.size();
+}
+
+void SectionWriter::add(const Section &section) {
+    put(section.title);
+    put(section.section);
+    put(section.heading);
+    put(section.body);
+}
+
+void SectionWriter::finish() {
+    index.push_back(at);
+    // The index is aligned, so it can be read where it is mapped
+    const uint64_t indexAt = (at + 7) / 8 * 8;
+    for (; at < indexAt; at++)
+        out.put('\0');
+    out.write(reinterpret_cast<const char *>(index.data()),
+              index.size() * sizeof(uint64_t));
+    out.write(binaryEndMark, sizeof(binaryEndMark));
+    out.seekp(sizeof(magic));
+    writeBinary(out, size());
+    writeBinary(out, indexAt);
+    out.close();
+    if (!out)
+        throw Exception("Can't write " + path + ".tmp");
+
+    const string temp = path + ".tmp";
+    std::remove(path.c_str());
+    if (std::rename(temp.c_str(), path.c_str()) != 0)
+        throw Exception("Can't rename " + temp + " to " + path);
+}
+
+SectionFile::SectionFile(const string &path) : file(path) {
+    const char *data = file.data();
+    const size_t size = file.size();
+    if (size < headerSize + sizeof(binaryEndMark) ||
+        !std::equal(magic, magic + sizeof(magic), data))
+        throw Exception(path + " is of another kind or version");
+
+    uint64_t header[2];
+    std::copy(data + sizeof(magic), data + headerSize,
+              reinterpret_cast<char *>(header));
+    const uint64_t indexAt = header[1];
+    count = header[0];
+    if (indexAt % 8 != 0 || indexAt < headerSize || indexAt > size ||
+        count > (size - indexAt) / (4 * sizeof(uint64_t)) ||
+        size != indexAt + (4 * count + 1) * sizeof(uint64_t) +
+                    sizeof(binaryEndMark) ||
+        !std::equal(binaryEndMark, binaryEndMark + sizeof(binaryEndMark),
+                    data + size - sizeof(binaryEndMark)))
+        throw Exception(path + " is truncated");
+
+    index = reinterpret_cast<const uint64_t *>(data + indexAt);
+    uint64_t last = headerSize;
+    for (size_t i = 0; i <= 4 * count; i++) {
+        if (index[i] < last || index[i] > indexAt)
+            throw Exception(path + " has a broken index");
+        last = index[i];
+    }
+}
+
+Section SectionFile::operator[](size_t i) const {
+    const uint64_t *at = index + 4 * i;
+    auto part = [&](size_t k) {
+        return string_view(file.data() + at[k], at[k + 1] - at[k]);
+    };
+    return Section{part(0), part(1), part(2), part(3)};
+}
+
+} // namespace parseWiki
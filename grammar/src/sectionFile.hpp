@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+using std::string, std::string_view;
+using std::vector;
+
+#include "mappedFile.hpp"
+
+namespace parseWiki {
+
+// The subsections of the dump the grammar parsers look at, so they can be
+// parsed again without reading the dump. The file is meant to be mapped:
+//
+//   magic, number of subsections, offset of the index   8 bytes each
+//   the text of all subsections, one after the other
+//   the index: where the title, section heading, subsection heading and
+//     body of every subsection start, then where the text ends
+//   end mark
+//
+// The numbers are 64 bits as in memory, like the files of binaryIO.hpp.
+
+struct Section {
+    string_view title;   // Of the page
+    string_view section; // Heading with the language
+    string_view heading; // Of the subsection, with the word class
+    string_view body;
+};
+
+// Writes a section file next to path and moves it over path when done
+class SectionWriter {
+  private:
+    string path;
+    std::ofstream out;
+    vector<uint64_t> index;
+    uint64_t at;
+
+    void put(const string_view &text);
+
+  public:
+    explicit SectionWriter(const string &path);
+
+    void add(const Section &section);
+    size_t size() const { return index.size() / 4; }
+
+    // Writes the index. Without it the file is left unfinished.
+    void finish();
+};
+
+// A mapped section file. Throws an Exception if it is missing or corrupt.
+class SectionFile {
+  private:
+    MappedFile file;
+    const uint64_t *index = nullptr;
+    size_t count = 0;
+
+  public:
+    explicit SectionFile(const string &path);
+
+    size_t size() const { return count; }
+    Section operator[](size_t i) const;
+};
+
+} // namespace parseWiki
@@ -0,0 +1,447 @@
+#include "spill.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+using std::cout, std::endl;
+using std::vector;
+
+#include "binaryIO.hpp"
+#include "mergeDict.hpp"
+#include "stats.hpp"
+
+namespace parseWiki {
+
+static const char runMagic[8] = {'P', 'W', 'R', 'U', 'N', '0', '0', '2'};
+
+// Position of the forms in the buckets, they keep their order
+static const uint64_t inflected = uint64_t(-1);
+
+// Estimated memory of the entries: the objects and what their strings and
+// vectors allocate
+static size_t heap(const string &s) {
+    static const size_t inPlace = string().capacity();
+    return s.capacity() > inPlace ? s.capacity() + 1 : 0;
+}
+static size_t heap(const vector<string> &v) {
+    size_t bytes = v.capacity() * sizeof(string);
+    for (const string &s : v)
+        bytes += heap(s);
+    return bytes;
+}
+static size_t heap(const Numeri &n) {
+    return heap(n.singular) + heap(n.plural);
+}
+static size_t heap(const Person &p) {
+    return heap(p.first) + heap(p.second) + heap(p.third);
+}
+static size_t heap(const WithCases &c) {
+    size_t bytes = 0;
+    for (size_t i = 0; i < 4; i++)
+        bytes += heap(c.cases[i]);
+    return bytes;
+}
+static size_t heap(const Verb &v) {
+    return heap(v.base.presentInfinitive) + heap(v.base.present) +
+           heap(v.base.participleII) + heap(v.base.subjunctive_firstSingular) +
+           heap(v.base.irrealis_firstSingular) +
+           heap(v.base.preterite_firstSingular) + heap(v.base.auxiliary) +
+           heap(v.imperative);
+}
+static size_t heap(const Adjective &a) {
+    size_t bytes =
+        heap(a.positive) + heap(a.comparative) + heap(a.superlative);
+    for (size_t i = 0; i < 9; i++)
+        bytes += heap(a.cases[i]);
+    return bytes;
+}
+static size_t heap(const Adverb &a) {
+    return heap(a.positive) + heap(a.comparative) + heap(a.superlative);
+}
+static size_t heap(const InflectedForm &f) {
+    return heap(f.form) + heap(f.lemma);
+}
+template <typename T> static size_t footprint(const T &entry) {
+    return sizeof(T) + heap(entry);
+}
+
+template <typename T>
+static size_t countNew(const vector<T> &entries, size_t &counted) {
+    size_t bytes = 0;
+    for (; counted < entries.size(); counted++)
+        bytes += footprint(entries[counted]);
+    return bytes;
+}
+
+template <typename T>
+static void writeRun(const string &path, const vector<T> &entries,
+                     const vector<InflectedForm> &forms) {
+    writeBinaryFile(path, runMagic, [&](ostream &out) {
+        writeBinary(out, entries.size());
+        for (const T &e : entries)
+            writeBinary(out, e);
+        writeBinary(out, forms.size());
+        for (const InflectedForm &f : forms)
+            writeBinary(out, f);
+    });
+}
+
+// Calls onEntry and onForm for the entries and forms of all runs in order
+template <typename T, typename E, typename F>
+static void readRuns(const vector<string> &paths, E onEntry, F onForm) {
+    T entry;
+    InflectedForm form;
+    for (const string &path : paths) {
+        const bool found = readBinaryFile(path, runMagic, [&](istream &in) {
+            for (uint64_t n = readSize(in); n > 0; n--) {
+                readBinary(in, entry);
+                onEntry(entry);
+            }
+            for (uint64_t n = readSize(in); n > 0; n--) {
+                readBinary(in, form);
+                onForm(form);
+            }
+        });
+        if (!found)
+            throw Exception("Missing run file " + path);
+    }
+}
+
+// Forms joined into groups, with every form of an entry in the same group
+class FormGroups {
+  private:
+    std::unordered_map<string, size_t> ids;
+    vector<size_t> parent;
+
+    size_t find(size_t id) {
+        while (parent[id] != id)
+            id = parent[id] = parent[parent[id]];
+        return id;
+    }
+
+  public:
+    void join(const InflectedForm &f) {
+        join(f.formIsKey ? vector<string>{f.lemma, f.form}
+                         : vector<string>{f.lemma});
+    }
+    void join(const vector<string> &forms) {
+        size_t first = 0;
+        for (size_t f = 0; f < forms.size(); f++) {
+            auto [it, added] = ids.emplace(forms[f], parent.size());
+            if (added)
+                parent.push_back(it->second);
+            const size_t root = find(it->second);
+            if (f == 0)
+                first = root;
+            else if (root != first)
+                parent[root] = first;
+        }
+    }
+
+    // Group of the forms or npos if there are none. Only for joined forms.
+    size_t group(const vector<string> &forms) {
+        return forms.empty() ? string::npos : find(ids.at(forms[0]));
+    }
+    size_t group(const InflectedForm &f) { return find(ids.at(f.lemma)); }
+};
+
+static std::ifstream openBucket(const string &path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.good())
+        throw Exception("Can't read " + path);
+    return in;
+}
+
+// Buckets open at once. Each takes a file handle, and the C runtime of MSVC
+// has no more than 512 streams.
+static const size_t openBuckets = 64;
+
+// Names the bucket files of a word class and deletes them all when it goes,
+// also if finishing the word class fails
+class BucketFiles {
+  private:
+    string prefix;
+    size_t made = 0;
+
+  public:
+    explicit BucketFiles(const string &prefix) : prefix(prefix) {}
+    BucketFiles(const BucketFiles &) = delete;
+    BucketFiles &operator=(const BucketFiles &) = delete;
+    ~BucketFiles() {
+        for (size_t b = 0; b < made; b++)
+            std::remove(path(b).c_str());
+    }
+
+    string path(size_t b) const { return prefix + std::to_string(b); }
+
+    // The path of a new bucket
+    string add() { return path(made++); }
+};
+
+// Merges buckets of entries that are sorted by their position and calls
+// onEntry with them in the order of their positions
+template <typename T, typename E>
+static void mergeBuckets(const vector<string> &paths, E onEntry) {
+    vector<std::ifstream> ins;
+    vector<T> heads(paths.size());
+    typedef std::pair<uint64_t, size_t> Head; // Position and bucket
+    std::priority_queue<Head, vector<Head>, std::greater<Head>> next;
+    for (size_t b = 0; b < paths.size(); b++) {
+        ins.push_back(openBucket(paths[b]));
+        if (ins[b].peek() != EOF) {
+            const uint64_t at = readNumber(ins[b]);
+            readBinary(ins[b], heads[b]);
+            next.emplace(at, b);
+        }
+    }
+    while (!next.empty()) {
+        const size_t b = next.top().second;
+        onEntry(next.top().first, heads[b]);
+        next.pop();
+        if (ins[b].peek() != EOF) {
+            const uint64_t at = readNumber(ins[b]);
+            readBinary(ins[b], heads[b]);
+            next.emplace(at, b);
+        }
+    }
+}
+
+// Groups, merges, simplifies and serializes one word class of all runs
+template <typename T>
+static void finishClass(const vector<string> &runs, const string &buckets,
+                        size_t budget, Stage stage, ostream &out,
+                        size_t &merged, size_t &tryMerge, size_t &removed) {
+    FormGroups groups;
+    size_t bytes = 0, entries = 0;
+    readRuns<T>(
+        runs,
+        [&](const T &e) {
+            groups.join(mergeKey(e));
+            bytes += footprint(e);
+            entries++;
+        },
+        [&](const InflectedForm &f) {
+            groups.join(f);
+            bytes += footprint(f);
+        });
+
+    // Spread the groups over the buckets, the entries with their position.
+    // Only so many buckets are written at once, the runs are read again for
+    // the others.
+    const size_t count = 1 + 2 * bytes / std::max<size_t>(budget, 1);
+    BucketFiles files(buckets);
+    vector<string> paths;
+    for (size_t first = 0; first < count; first += openBuckets) {
+        const size_t last = std::min(count, first + openBuckets);
+        vector<std::ofstream> parts;
+        for (size_t b = first; b < last; b++) {
+            paths.push_back(files.add());
+            parts.emplace_back(paths.back(),
+                               std::ios::binary | std::ios::trunc);
+            if (!parts.back().good())
+                throw Exception("Can't write " + paths.back());
+        }
+        uint64_t position = 0;
+        readRuns<T>(
+            runs,
+            [&](const T &e) {
+                const size_t group = groups.group(mergeKey(e));
+                const size_t b =
+                    (group == string::npos ? position : group) % count;
+                if (b >= first && b < last) {
+                    writeBinary(parts[b - first], position);
+                    writeBinary(parts[b - first], e);
+                }
+                position++;
+            },
+            [&](const InflectedForm &f) {
+                const size_t b = groups.group(f) % count;
+                if (b >= first && b < last) {
+                    writeBinary(parts[b - first], inflected);
+                    writeBinary(parts[b - first], f);
+                }
+            });
+        for (size_t b = first; b < last; b++)
+            if (!parts[b - first].flush())
+                throw Exception("Can't write " + paths[b]);
+    }
+
+    // Merge every bucket on its own, the result stays in the order of the dump
+    for (const string &path : paths) {
+        vector<T> into;
+        vector<InflectedForm> from;
+        vector<uint64_t> positions;
+        {
+            std::ifstream in = openBucket(path);
+            while (in.peek() != EOF) {
+                const uint64_t at = readNumber(in);
+                if (at == inflected) {
+                    from.emplace_back();
+                    readBinary(in, from.back());
+                } else {
+                    positions.push_back(at);
+                    into.emplace_back();
+                    readBinary(in, into.back());
+                }
+            }
+        }
+        {
+            const StageTimer timer(stage);
+            mergeForms(into, from, merged, tryMerge);
+        }
+        for (T &e : into)
+            removed += Dictionary::simplifyEntry(e);
+
+        std::ofstream part(path, std::ios::binary | std::ios::trunc);
+        for (size_t i = 0; i < into.size(); i++) {
+            writeBinary(part, positions[i]);
+            writeBinary(part, into[i]);
+        }
+        if (!part.flush())
+            throw Exception("Can't write " + path);
+    }
+
+    // Serialize the buckets merged back into one sequence. If there are too
+    // many to open at once, they are merged into fewer first.
+    const StageTimer timer(Stage::serialize);
+    while (paths.size() > openBuckets) {
+        vector<string> fewer;
+        for (size_t first = 0; first < paths.size(); first += openBuckets) {
+            const vector<string> some(
+                paths.begin() + first,
+                paths.begin() + std::min(paths.size(), first + openBuckets));
+            fewer.push_back(files.add());
+            std::ofstream part(fewer.back(),
+                               std::ios::binary | std::ios::trunc);
+            mergeBuckets<T>(some, [&](uint64_t at, const T &e) {
+                writeBinary(part, at);
+                writeBinary(part, e);
+            });
+            if (!part.flush())
+                throw Exception("Can't write " + fewer.back());
+            for (const string &path : some)
+                std::remove(path.c_str());
+        }
+        paths = std::move(fewer);
+    }
+    out << entries << "\n";
+    mergeBuckets<T>(paths, [&](uint64_t, const T &e) {
+        e.serialize(out);
+        out << "\n";
+    });
+}
+
+// Adverbs aren't merged, they only have to be simplified
+static void finishAdverbs(const vector<string> &runs, ostream &out,
+                          size_t &removed) {
+    size_t entries = 0;
+    auto noForms = [](const InflectedForm &) {};
+    readRuns<Adverb>(
+        runs, [&](const Adverb &) { entries++; }, noForms);
+    const StageTimer timer(Stage::serialize);
+    out << entries << "\n";
+    readRuns<Adverb>(
+        runs,
+        [&](Adverb &e) {
+            removed += Dictionary::simplifyEntry(e);
+            e.serialize(out);
+            out << "\n";
+        },
+        noForms);
+}
+
+static const char *classNames[] = {"nouns", "verbs", "adjectives", "adverbs",
+                                   "pronouns"};
+
+string SpillRuns::path(size_t run, const char *what) const {
+    return spilling.dir + "/run" + std::to_string(run) + "." + what;
+}
+
+void SpillRuns::resume(size_t runs) {
+    this->runs = runs;
+    for (size_t run = runs;; run++) {
+        bool left = false;
+        for (const char *name : classNames) {
+            left |= std::remove(path(run, name).c_str()) == 0;
+            left |= std::remove((path(run, name) + ".tmp").c_str()) == 0;
+        }
+        if (!left)
+            break;
+    }
+}
+
+void SpillRuns::check(Dictionary &dict, FormIndex &forms) {
+    held += countNew(dict.nouns, counted[0]);
+    held += countNew(dict.verbs, counted[1]);
+    held += countNew(dict.adjectives, counted[2]);
+    held += countNew(dict.adverbs, counted[3]);
+    held += countNew(dict.pronouns, counted[4]);
+    held += countNew(forms.nouns, counted[5]);
+    held += countNew(forms.verbs, counted[6]);
+    held += countNew(forms.adjectives, counted[7]);
+    held += countNew(forms.pronouns, counted[8]);
+    if (held > spilling.budget) {
+        cout << endl
+             << "Spilling " << held / 1000000 << " MB to run " << runs
+             << endl;
+        spill(dict, forms);
+    }
+}
+
+void SpillRuns::spill(Dictionary &dict, FormIndex &forms) {
+    writeRun(path(runs, "nouns"), dict.nouns, forms.nouns);
+    writeRun(path(runs, "verbs"), dict.verbs, forms.verbs);
+    writeRun(path(runs, "adjectives"), dict.adjectives, forms.adjectives);
+    writeRun(path(runs, "adverbs"), dict.adverbs, vector<InflectedForm>());
+    writeRun(path(runs, "pronouns"), dict.pronouns, forms.pronouns);
+    runs++;
+
+    dict = Dictionary();
+    forms = FormIndex();
+    held = 0;
+    std::fill(counted, counted + 9, 0);
+}
+
+void SpillRuns::finish(Dictionary &dict, FormIndex &forms, ostream &out) {
+    spill(dict, forms);
+
+    cout << endl << "merging " << runs << " runs..." << endl;
+    auto paths = [&](const char *name) {
+        vector<string> all;
+        for (size_t run = 0; run < runs; run++)
+            all.push_back(path(run, name));
+        return all;
+    };
+    auto buckets = [&](const char *name) {
+        return spilling.dir + "/" + name + ".bucket";
+    };
+    size_t merged = 0, tryMerge = 0, removed = 0;
+    finishClass<Noun>(paths("nouns"), buckets("nouns"), spilling.budget,
+                      Stage::mergeNouns, out, merged, tryMerge, removed);
+    finishClass<Verb>(paths("verbs"), buckets("verbs"), spilling.budget,
+                      Stage::mergeVerbs, out, merged, tryMerge, removed);
+    finishClass<Adjective>(paths("adjectives"), buckets("adjectives"),
+                           spilling.budget, Stage::mergeAdjectives, out,
+                           merged, tryMerge, removed);
+    finishAdverbs(paths("adverbs"), out, removed);
+    finishClass<Pronoun>(paths("pronouns"), buckets("pronouns"),
+                         spilling.budget, Stage::mergePronouns, out, merged,
+                         tryMerge, removed);
+
+    cout << endl << "merged " << merged << " of " << tryMerge << endl;
+    cout << "   removed empty: " << removed << endl;
+}
+
+void SpillRuns::remove() {
+    for (size_t run = 0; run < runs; run++)
+        for (const char *name : classNames)
+            std::remove(path(run, name).c_str());
+}
+
+} // namespace parseWiki
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+using std::ostream;
+using std::string;
+
+#include "dictionary.hpp"
+#include "formIndex.hpp"
+
+namespace parseWiki {
+
+// Lets parseWiki keep only part of the parsed entries in memory
+struct Spilling {
+    string dir;                      // Existing folder for the run files
+    size_t budget = size_t(1) << 30; // Bytes of entries to keep in memory
+};
+
+// The parsed entries that have been moved out of memory. Every run holds what
+// dict and forms had when the budget was reached, in one file per word class
+// and in the order of the dump.
+//
+// At the end the entries and forms of a word class are grouped by their merge
+// keys: those that share no key, not even through others, can't be merged
+// into each other. The groups are spread over buckets of about half the budget,
+// every bucket is merged and simplified on its own and the buckets are merged
+// back into the order of the dump while serializing. No more than 64 buckets
+// are open at once, the runs are read once for every 64 and the buckets are
+// merged in rounds. The result is the same as mergeDict, simplify and
+// serialize on the whole dictionary.
+class SpillRuns {
+  private:
+    Spilling spilling;
+    size_t runs;
+    size_t held = 0;         // Estimated bytes of the entries in memory
+    size_t counted[9] = {};  // Entries of dict and forms in held
+
+    string path(size_t run, const char *what) const;
+
+  public:
+    explicit SpillRuns(const Spilling &spilling)
+        : spilling(spilling), runs(0) {}
+
+    // Continues after the given number of runs of an earlier attempt. Later
+    // ones it left behind are deleted.
+    void resume(size_t runs);
+
+    size_t count() const { return runs; }
+
+    // Counts what was added to dict and forms since the last call and spills
+    // all of it once it takes more than the budget
+    void check(Dictionary &dict, FormIndex &forms);
+
+    // Moves the entries of dict and forms to a new run
+    void spill(Dictionary &dict, FormIndex &forms);
+
+    // Spills the rest and writes the merged and simplified entries of all runs
+    // to out the way Dictionary::serialize does
+    void finish(Dictionary &dict, FormIndex &forms, ostream &out);
+
+    // Deletes the run files
+    void remove();
+};
+
+} // namespace parseWiki
@@ -0,0 +1,141 @@
+#include "stats.hpp"
+
+#include <iomanip>
+#include <iostream>
+using std::cout, std::endl;
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+// Without psapi.lib, K32GetProcessMemoryInfo is in kernel32
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace parseWiki {
+
+static const char *stageNames[] = {
+    "read",          "parse",           "split",
+    "grammar",       "buildNoun",       "buildVerb",
+    "buildAdjective", "buildAdverb",    "buildPronoun",
+    "buildDeclined", "mergeDict",       "mergeNouns",
+    "mergeAdjectives", "mergePronouns", "mergeVerbs",
+    "simplify",      "serialize",       "buildMap"};
+static_assert(sizeof(stageNames) / sizeof(stageNames[0]) ==
+                  size_t(Stage::count),
+              "a stage has no name");
+
+void Stats::add(Stage stage, uint64_t ns) {
+    nanos[size_t(stage)] += ns;
+    calls[size_t(stage)]++;
+}
+
+void Stats::addRun(uint64_t pages, uint64_t bytes, double seconds) {
+    this->pages += pages;
+    this->bytes += bytes;
+    this->seconds += seconds;
+}
+
+void Stats::report(ostream &out, const Dictionary &dict) const {
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+    out << std::fixed << std::setprecision(2);
+
+    out << endl << std::left << std::setw(16) << "stage" << std::right
+        << std::setw(12) << "calls" << std::setw(12) << "seconds" << endl;
+    for (size_t i = 0; i < stages; i++) {
+        if (calls[i] == 0)
+            continue;
+        out << std::left << std::setw(16) << stageNames[i] << std::right
+            << std::setw(12) << calls[i].load() << std::setw(12)
+            << nanos[i].load() / 1e9
+            << endl;
+    }
+
+    out << endl
+        << pages << " pages read, " << calls[size_t(Stage::parse)].load()
+        << " parsed, " << reused.load() << " reused" << endl;
+    if (seconds > 0)
+        out << pages / seconds << " pages/s, " << bytes / seconds / 1e6
+            << " MB/s in " << seconds << " s" << endl;
+    out << "peak memory " << peakMemory() / 1e6 << " MB" << endl;
+
+    out << endl
+        << dict.nouns.size() << " nouns" << endl
+        << dict.verbs.size() << " verbs" << endl
+        << dict.adjectives.size() << " adjectives" << endl
+        << dict.adverbs.size() << " adverbs" << endl
+        << dict.pronouns.size() << " pronouns" << endl;
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+Stats &stats() {
+    static Stats all;
+    return all;
+}
+
+void StageTimer::stop() {
+    if (!running)
+        return;
+    running = false;
+    const auto took = std::chrono::steady_clock::now() - start;
+    stats().add(stage,
+                std::chrono::duration_cast<std::chrono::nanoseconds>(took)
+                    .count());
+}
+
+size_t peakMemory() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters,
+                              sizeof(counters)))
+        return 0;
+    return counters.PeakWorkingSetSize;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return size_t(usage.ru_maxrss) * 1024; // In KiB on Linux
+#endif
+}
+
+ProgressMeter::ProgressMeter(size_t total,
+                             std::function<size_t(size_t)> position,
+                             size_t pages, size_t offset, size_t at)
+    : total(total), position(position), firstPages(pages),
+      firstOffset(offset), firstPosition(at),
+      started(Clock::now()), shown(started) {}
+
+void ProgressMeter::update(size_t pages, size_t offset) {
+    const Clock::time_point now = Clock::now();
+    if (now - shown < std::chrono::seconds(1))
+        return;
+    shown = now;
+
+    const double seconds =
+        std::chrono::duration<double>(now - started).count();
+    const size_t at = position(offset);
+    cout << "\r" << pages << " pages, "
+         << size_t((pages - firstPages) / seconds) << " pages/s, "
+         << size_t((offset - firstOffset) / seconds / 1e6) << " MB/s";
+    if (total > 0 && at > firstPosition && at <= total) {
+        const size_t left =
+            size_t(seconds * (total - at) / (at - firstPosition));
+        cout << ", " << 100 * at / total << "%, " << left / 60 << " min "
+             << left % 60 << " s left";
+    }
+    cout << "   " << std::flush;
+}
+
+void ProgressMeter::finish(size_t pages, size_t offset) {
+    const double seconds =
+        std::chrono::duration<double>(Clock::now() - started).count();
+    if (shown != started)
+        cout << endl;
+    stats().addRun(pages - firstPages, offset - firstOffset, seconds);
+}
+
+} // namespace parseWiki
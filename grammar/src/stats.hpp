@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+using std::ostream;
+
+#include "dictionary.hpp"
+
+namespace parseWiki {
+
+// Timed parts of the ingestion. split, grammar and the builds happen inside
+// parse, the builds inside grammar. The word classes are merged at the same
+// time inside mergeDict.
+enum class Stage {
+    read,
+    parse,
+    split,
+    grammar,
+    buildNoun,
+    buildVerb,
+    buildAdjective,
+    buildAdverb,
+    buildPronoun,
+    buildDeclined,
+    mergeDict,
+    mergeNouns,
+    mergeAdjectives,
+    mergePronouns,
+    mergeVerbs,
+    simplify,
+    serialize,
+    buildMap,
+    count
+};
+
+// Counters for one ingestion. Stages are timed on every thread, so the times
+// of the parse stages add up to more than the wall clock.
+class Stats {
+  private:
+    static const size_t stages = size_t(Stage::count);
+    std::atomic<uint64_t> nanos[stages] = {};
+    std::atomic<uint64_t> calls[stages] = {};
+    std::atomic<uint64_t> reused{0};
+    uint64_t pages = 0, bytes = 0;
+    double seconds = 0;
+
+  public:
+    void add(Stage stage, uint64_t ns);
+    void addReused() { reused++; }
+
+    // Pages and bytes read by a run, for the rates in the report
+    void addRun(uint64_t pages, uint64_t bytes, double seconds);
+
+    // Times, rates, peak memory and the entries of dict per word class
+    void report(ostream &out, const Dictionary &dict) const;
+};
+
+Stats &stats();
+
+// Adds the time until it is stopped or destroyed to the stage
+class StageTimer {
+  private:
+    Stage stage;
+    std::chrono::steady_clock::time_point start;
+    bool running = true;
+
+  public:
+    explicit StageTimer(Stage stage)
+        : stage(stage), start(std::chrono::steady_clock::now()) {}
+    ~StageTimer() { stop(); }
+    StageTimer(const StageTimer &) = delete;
+    StageTimer &operator=(const StageTimer &) = delete;
+
+    void stop();
+};
+
+// Peak working set of the process in bytes, 0 if unknown
+size_t peakMemory();
+
+// Keeps a line with the progress, the rates and the time left up to date
+// while the dump is read. position turns an input offset into a position in
+// the dump file, which has total bytes (0 if unknown: no time left then). The
+// run starts after pages at the input offset and the position at.
+class ProgressMeter {
+  private:
+    typedef std::chrono::steady_clock Clock;
+    size_t total;
+    std::function<size_t(size_t)> position;
+    size_t firstPages, firstOffset, firstPosition;
+    Clock::time_point started, shown;
+
+  public:
+    ProgressMeter(size_t total, std::function<size_t(size_t)> position,
+                  size_t pages, size_t offset, size_t at);
+
+    // Prints at most once a second
+    void update(size_t pages, size_t offset);
+
+    // Ends the line and adds the run to stats()
+    void finish(size_t pages, size_t offset);
+};
+
+} // namespace parseWiki
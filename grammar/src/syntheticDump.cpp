@@ -0,0 +1,428 @@
+#include "syntheticDump.hpp"
+
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <utility>
+using std::endl;
+using std::string_view;
+
+#include "parseWiki.hpp"
+#include "stats.hpp"
+#include "util.hpp"
+
+namespace parseWiki {
+
+static const char *syllables[] = {
+    "ha",  "us",   "be",  "ro", "ma",   "ki",   "lo",  "te",
+    "rä",  "schö", "pf",  "er", "gen",  "mun",  "dü",  "bau",
+    "wei", "stra", "ße",  "ling", "heit", "ung"};
+
+static const char *cases[] = {"Nominativ", "Genitiv", "Dativ", "Akkusativ"};
+static const char *numbers[] = {"Singular", "Plural"};
+
+// Builds the text of the pages. Only the engine's own numbers are used, since
+// the distributions of <random> differ between standard libraries.
+class SyntheticPages {
+  private:
+    std::mt19937 engine;
+    vector<string> nouns; // Lemmas for the declined forms
+
+    size_t below(size_t n) { return engine() % n; }
+    bool chance(double p) { return engine() < p * 4294967296.0; }
+    template <typename T, size_t N> const T &pick(const T (&items)[N]) {
+        return items[below(N)];
+    }
+
+    string lower(string word) const;
+    string section(const string &heading, const string &body);
+    string noun(const string &t, string &heading);
+    string verb(string &t, string &heading);
+    string adjective(string &t, string &heading);
+    string pronoun(string &t, string &heading);
+    string adverb(string &t, string &heading);
+    string declined(const string &t, string &heading);
+    string foreign(const string &t);
+    string german(string &title);
+
+  public:
+    explicit SyntheticPages(uint32_t seed) : engine(seed) {}
+
+    string word();
+
+    // The wikitext of a page with the given title, which may be changed
+    string page(string &title, size_t &ns);
+
+    bool brokenSize() { return chance(0.01); }
+};
+
+string SyntheticPages::word() {
+    string w;
+    const size_t n = 1 + below(4);
+    for (size_t i = 0; i < n; i++)
+        w += pick(syllables);
+    if (uint8_t(w[0]) < 0x80)
+        w[0] = char(std::toupper(w[0]));
+    return w;
+}
+
+string SyntheticPages::lower(string word) const {
+    if (!word.empty() && uint8_t(word[0]) < 0x80)
+        word[0] = char(std::tolower(word[0]));
+    return word;
+}
+
+string SyntheticPages::section(const string &heading, const string &body) {
+    static const char *extras[] = {
+        "{{Aussprache}}\n:{{IPA}} {{Lautschrift|ˈhaʊ̯s}}\n\n",
+        "{{Bedeutungen}}\n:[1] Gebäude\n:[2] ''übertragen:'' Familie\n\n",
+        "{{Herkunft}}\n:von mittelhochdeutsch ''hūs''\n\n",
+        "{{Beispiele}}\n:[1] Das {{Pl.}} ist ''schön''.\n\n"};
+    string text = "=== {{Wortart|" + heading + " ===\n\n" + body + "\n";
+    const size_t n = below(4);
+    for (size_t i = 0; i < n; i++)
+        text += pick(extras);
+    if (chance(0.5))
+        text += "==== {{Übersetzungen}} ====\n{{Ü-Tabelle|Ü-links=\n"
+                "*{{en}}: [1] {{Ü|en|house}}\n}}\n\n";
+    if (chance(0.1))
+        text += "==== {{Ü-Tabelle}}, {{Übersetzungen}} ====\nfoo\n";
+    return text;
+}
+
+string SyntheticPages::noun(const string &t, string &heading) {
+    static const char *genera[] = {"m", "f", "n"};
+    static const char *endings[] = {"e", "en", "er", "s", ""};
+    const string g = pick(genera);
+    const string pl = t + pick(endings);
+    vector<string> props = {
+        "|Genus=" + g,
+        "|Nominativ Singular=" + t,
+        "|Nominativ Plural=" + pl,
+        "|Genitiv Singular=" + t + "s",
+        "|Genitiv Plural=" + pl,
+        "|Dativ Singular=" + t,
+        "|Dativ Plural=" + pl + "n",
+        "|Akkusativ Singular=" + t,
+        "|Akkusativ Plural=" + pl};
+    if (chance(0.3))
+        props.push_back("|Dativ Singular*=" + t + "e");
+    if (chance(0.2))
+        props.push_back("|Nominativ Plural 2=" + pl + "s");
+    if (chance(0.1))
+        props.push_back("|Genitiv Singular**=" + t + "es");
+    if (chance(0.2))
+        props.push_back("|Bild=Foo.jpg|mini|1|[[" + t + "]]");
+    if (chance(0.05))
+        props.push_back("|kein Plural=ja");
+    if (chance(0.05))
+        props.push_back("|Unbekannt=x");
+    if (chance(0.05))
+        props.push_back("|Nominativ Singular=<!-- kommentar -->");
+    if (chance(0.05))
+        props.push_back("|Nominativ Plural=—");
+    if (chance(0.05))
+        props.push_back("|Genitiv Plural=A &amp; B");
+    for (size_t i = props.size(); i > 1; i--)
+        std::swap(props[i - 1], props[below(i)]);
+
+    string body;
+    switch (below(4)) {
+    case 0:
+        heading = "Substantiv|Deutsch}}, {{" + g + "}}";
+        break;
+    case 1:
+        heading = "Substantiv|Deutsch}}";
+        break;
+    case 2:
+        heading = "Toponym|Deutsch}}";
+        body = "{{Deutsch Toponym Übersicht\n|Genus=n\n|Nominativ Singular=" +
+               t + "\n|Genitiv Singular=" + t + "s\n}}\n";
+        break;
+    default:
+        heading = "Nachname|Deutsch}}, {{" + g + "}}";
+    }
+    if (body.empty()) {
+        body = "{{Deutsch Substantiv Übersicht\n";
+        for (const string &prop : props)
+            body += prop + "\n";
+        body += "}}\n";
+    }
+    body += "\n{{Worttrennung}}\n:" + t + ", {{Pl.}} " + pl;
+    if (chance(0.05))
+        body += " {{kPl.}}";
+    return body + "\n";
+}
+
+string SyntheticPages::verb(string &t, string &heading) {
+    const string stem = lower(t);
+    t = stem + "en";
+    vector<string> props = {"|Präsens_ich=" + stem + "e",
+                            "|Präsens_du=" + stem + "st",
+                            "|Präsens_er, sie, es=" + stem + "t",
+                            "|Präteritum_ich=" + stem + "te",
+                            "|Partizip II=ge" + stem + "t",
+                            "|Konjunktiv II_ich=" + stem + "te",
+                            "|Imperativ Singular=" + stem,
+                            "|Imperativ Plural=" + stem + "t",
+                            "|Hilfsverb=haben"};
+    if (chance(0.3))
+        props.push_back("|Präsens_du*=" + stem + "est");
+    if (chance(0.2))
+        props.push_back("|Imperativ Singular 2=" + stem + "e");
+    if (chance(0.1))
+        props.push_back("|Weitere_Konjugationen=" + t + " (Konjugation)");
+    if (chance(0.1))
+        props.push_back("|Konjunktiv I_ich=" + stem + "e");
+    for (size_t i = props.size(); i > 1; i--)
+        std::swap(props[i - 1], props[below(i)]);
+
+    heading = "Verb|Deutsch}}";
+    string body = "{{Deutsch Verb Übersicht\n";
+    for (const string &prop : props)
+        body += prop + "\n";
+    return body + "}}\n\n{{Worttrennung}}\n:" + t + "\n";
+}
+
+string SyntheticPages::adjective(string &t, string &heading) {
+    t = lower(t);
+    heading = "Adjektiv|Deutsch}}";
+    string body = "{{Deutsch Adjektiv Übersicht\n|Positiv=" + t +
+                  "\n|Komparativ=" + t + "er\n|Superlativ=am " + t + "sten\n";
+    if (chance(0.2))
+        body += "|Komparativ*=" + t + "rer\n";
+    if (chance(0.1))
+        body += "|keine weiteren Formen=ja\n";
+    return body + "}}\n";
+}
+
+string SyntheticPages::pronoun(string &t, string &heading) {
+    static const char *kinds[] = {"Personalpronomen", "Possessivpronomen",
+                                  "Demonstrativpronomen", "Indefinitpronomen"};
+    t = lower(t);
+    heading = string(pick(kinds)) + "|Deutsch}}";
+    if (chance(0.5))
+        return "{{Deutsch Pronomen Übersicht\n|Nominativ Singular m=" + t +
+               "er\n|Nominativ Singular f=" + t +
+               "e\n|Nominativ Singular n=" + t + "es\n|Nominativ Plural=" +
+               t + "e\n|Genitiv Singular m=" + t + "es\n|Dativ Singular m=" +
+               t + "em\n|Akkusativ Plural=" + t + "e\n}}\n";
+    return "{{Worttrennung}}\n:" + t + ", {{Gen.}} " + t + "·ner, {{va.|:}} " +
+           t + "n, {{Dat.}} " + t + "r, {{Akk.}} " + t + "ch; {{Pl.}} " + t +
+           "r\n";
+}
+
+string SyntheticPages::adverb(string &t, string &heading) {
+    static const char *kinds[] = {"Adverb",      "Temporaladverb", "Partikel",
+                                  "Konjunktion", "Präposition",    "Interjektion",
+                                  "Subjunktion"};
+    t = lower(t);
+    heading = string(pick(kinds)) + "|Deutsch}}";
+    string body = "{{Worttrennung}}\n:" + t + "\n";
+    if (chance(0.3))
+        body = "{{Deutsch Adverb Übersicht\n|Positiv=" + t + "\n|Komparativ=" +
+               t + "er\n}}\n\n" + body;
+    return body;
+}
+
+string SyntheticPages::declined(const string &t, string &heading) {
+    const string lemma = nouns.empty() ? "Haus" : nouns[below(nouns.size())];
+    const string kase = pick(cases);
+    const string number = pick(numbers);
+    const size_t kind = below(20);
+    string meaning;
+    if (kind < 9) {
+        meaning = "*" + kase + " " + number + " des Substantivs '''[[" + lemma +
+                  "]]'''";
+        if (chance(0.3))
+            meaning += "\n*" + string(below(2) == 0 ? "Nominativ" : "Dativ") +
+                       " Plural des Substantivs '''[[" + lemma + "]]'''";
+    } else if (kind < 14) {
+        static const char *genera[] = {"Maskulinum", "Femininum", "Neutrum",
+                                       "alle Genera"};
+        static const char *degrees[] = {"Positivs", "Komparativs",
+                                        "Superlativs"};
+        meaning = "*" + kase + " " + number + " " + pick(genera) +
+                  " der starken Deklination des " + pick(degrees) +
+                  " des Adjektivs '''[[" + lower(lemma) + "]]'''";
+    } else if (kind < 18) {
+        static const char *persons[] = {"1. Person", "2. Person", "3. Person"};
+        static const char *modes[] = {"Indikativ", "Konjunktiv I",
+                                      "Konjunktiv II"};
+        static const char *tempora[] = {"Präsens", "Präteritum"};
+        meaning = "*" + string(pick(persons)) + " " + number + " " +
+                  pick(modes) + " " + pick(tempora) + " Aktiv des Verbs '''[[" +
+                  lower(lemma) + "en]]'''";
+        if (chance(0.2))
+            meaning = "*Imperativ Singular des Verbs '''[[" + lower(lemma) +
+                      "en]]'''";
+    } else {
+        meaning = "*" + kase + " " + number + " des Personalpronomens '''[[" +
+                  lower(lemma) + "]]'''";
+    }
+    heading = string(below(2) == 0 ? "Deklinierte Form" : "Konjugierte Form") +
+              "|Deutsch}}";
+    return "{{Worttrennung}}\n:" + t + "\n\n{{Grammatische Merkmale}}\n" +
+           meaning + "\n";
+}
+
+string SyntheticPages::foreign(const string &t) {
+    static const char *languages[] = {"Englisch", "Französisch", "Latein",
+                                      "Niederländisch"};
+    static const char *classes[] = {"Substantiv", "Verb", "Adjektiv",
+                                    "Vorname", "Nachname"};
+    const string language = pick(languages);
+    return "== " + t + " ({{Sprache|" + language + "}}) ==\n=== {{Wortart|" +
+           pick(classes) + "|" + language + "}} ===\n\n{{Worttrennung}}\n:" +
+           t + "\n\n{{Bedeutungen}}\n:[1] something\n\n";
+}
+
+string SyntheticPages::german(string &title) {
+    string heading, body;
+    const size_t kind = below(100);
+    if (kind < 35) {
+        body = noun(title, heading);
+        nouns.push_back(title);
+    } else if (kind < 50) {
+        body = verb(title, heading);
+    } else if (kind < 60) {
+        body = adjective(title, heading);
+    } else if (kind < 64) {
+        body = pronoun(title, heading);
+    } else if (kind < 70) {
+        body = adverb(title, heading);
+    } else {
+        body = declined(title, heading);
+    }
+
+    string text = "{{Siehe auch|[[" + lower(title) + "]]}}\n== " + title +
+                  " ({{Sprache|Deutsch}}) ==\n" + section(heading, body);
+    if (chance(0.2)) {
+        string nounHeading;
+        text += "=== {{Wortart|Substantiv|Deutsch}}, {{f}} ===\n\n" +
+                noun(title, nounHeading) + "\n";
+    }
+    if (chance(0.15))
+        text += foreign(title);
+    if (chance(0.03))
+        text = "{{Abkürzung}}\n" + text;
+    return text;
+}
+
+string SyntheticPages::page(string &title, size_t &ns) {
+    static const std::pair<size_t, const char *> spaces[] = {
+        {1, "Diskussion:"},
+        {4, "Wiktionary:"},
+        {10, "Vorlage:"},
+        {14, "Kategorie:"}};
+    ns = 0;
+    const size_t kind = below(100);
+    if (kind < 8) {
+        const auto &space = pick(spaces);
+        ns = space.first;
+        title = space.second + title;
+        return "Irgendwas == nicht == {{Sprache|Deutsch}} hier\n* [[foo]]\n";
+    }
+    if (kind < 25)
+        return foreign(title);
+    return german(title);
+}
+
+static void escaped(ostream &out, string_view text) {
+    for (const char c : text) {
+        switch (c) {
+        case '&':
+            out << "&amp;";
+            break;
+        case '<':
+            out << "&lt;";
+            break;
+        case '>':
+            out << "&gt;";
+            break;
+        case '"':
+            out << "&quot;";
+            break;
+        default:
+            out << c;
+        }
+    }
+}
+
+void writeSyntheticDump(ostream &out, size_t pages, uint32_t seed) {
+    SyntheticPages synthetic(seed);
+    out << "<mediawiki xmlns=\"http://www.mediawiki.org/xml/export-0.10/\" "
+           "version=\"0.10\" xml:lang=\"de\">\n"
+           "  <siteinfo>\n    <sitename>Wiktionary</sitename>\n"
+           "  </siteinfo>\n";
+    for (size_t id = 1; id <= pages; id++) {
+        string title = synthetic.word();
+        size_t ns;
+        const string text = synthetic.page(title, ns);
+        out << "  <page>\n    <title>";
+        escaped(out, title);
+        out << "</title>\n    <ns>" << ns << "</ns>\n    <id>" << id
+            << "</id>\n    <revision>\n      <id>" << id * 10 + id % 7
+            << "</id>\n      <parentid>" << id * 10 - 1
+            << "</parentid>\n"
+               "      <timestamp>2019-01-01T00:00:00Z</timestamp>\n"
+               "      <contributor>\n        <username>Bot</username>\n"
+               "        <id>1</id>\n      </contributor>\n"
+               "      <model>wikitext</model>\n"
+               "      <format>text/x-wiki</format>\n"
+               "      <text xml:space=\"preserve\"";
+        if (synthetic.brokenSize())
+            out << " bytes=\"12\"";
+        out << ">";
+        escaped(out, text);
+        out << "</text>\n      <sha1>abc</sha1>\n    </revision>\n"
+               "  </page>\n";
+    }
+    out << "</mediawiki>\n";
+}
+
+void benchmarkParse(ostream &out, const vector<size_t> &sizes,
+                    const string &dir, size_t threads) {
+    typedef std::chrono::steady_clock Clock;
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+    out << std::fixed << std::setprecision(2);
+
+    out << std::setw(10) << "pages" << std::setw(12) << "MB"
+        << std::setw(12) << "pages/s" << std::setw(12) << "MB/s"
+        << std::setw(16) << "peak memory MB" << endl;
+    for (const size_t pages : sizes) {
+        const string path = dir + "/synthetic-" + std::to_string(pages) +
+                            ".xml";
+        size_t bytes;
+        {
+            std::ofstream dump(path, std::ios::binary);
+            if (!dump.good())
+                throw Exception("Can't write " + path);
+            writeSyntheticDump(dump, pages);
+            bytes = size_t(dump.tellp());
+        }
+
+        const Clock::time_point start = Clock::now();
+        const Dictionary dict = parseWiki(
+            std::make_shared<std::ifstream>(path, std::ios::binary), threads);
+        const double seconds =
+            std::chrono::duration<double>(Clock::now() - start).count();
+        std::remove(path.c_str());
+
+        out << std::setw(10) << pages << std::setw(12) << bytes / 1e6
+            << std::setw(12) << pages / seconds << std::setw(12)
+            << bytes / seconds / 1e6 << std::setw(16) << peakMemory() / 1e6
+            << endl;
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+} // namespace parseWiki
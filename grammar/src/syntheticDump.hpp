@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+using std::ostream;
+using std::string;
+using std::vector;
+
+namespace parseWiki {
+
+// Writes a made up dump of the given number of pages in the XML format of
+// the real one. The pages are built from the templates and headings the
+// parsers understand, mixed about the way they are in the dewiktionary dump:
+// Substantiv, Verb, Adjektiv, Pronomen and Adverb Übersicht templates,
+// declined and conjugated forms of the words before them, sections of other
+// languages, pages of other namespaces and some broken or unknown fields.
+// The same seed gives the same dump on every platform.
+void writeSyntheticDump(ostream &out, size_t pages, uint32_t seed = 1);
+
+// Writes a synthetic dump of every size to a file in dir, parses it with
+// parseWiki on the given number of threads and prints pages/s, MB/s and the
+// peak memory so far. The sizes should go up, since the peak is the one of
+// the whole process. The files are deleted afterwards.
+void benchmarkParse(ostream &out, const vector<size_t> &sizes,
+                    const string &dir, size_t threads = 0);
+
+} // namespace parseWiki
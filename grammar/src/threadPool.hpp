@@ -0,0 +1,51 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+using std::vector;
+
+// A fixed set of threads that runs the tasks given to it. Tasks must not wait
+// for the pool themselves.
+class ThreadPool {
+  private:
+    vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t busy = 0; // Tasks taken but not done
+    bool stopping = false;
+    std::exception_ptr error;
+
+    void work();
+
+  public:
+    // 0 threads for one per core
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    size_t size() const { return workers.size(); }
+
+    void add(std::function<void()> task);
+
+    // Splits [0, count) into a few chunks per thread and adds f(begin, end)
+    // for each of them
+    template <typename F> void addChunks(size_t count, const F &f) {
+        const size_t chunks = std::min(count, 4 * size());
+        for (size_t c = 0; c < chunks; c++)
+            add([f, begin = count * c / chunks,
+                 end = count * (c + 1) / chunks]() { f(begin, end); });
+    }
+
+    // Waits until all tasks are done. Rethrows the first exception one of
+    // them threw.
+    void wait();
+};
@@ -1,16 +1,20 @@
 #include "util.hpp"
 
+#include "diagnostics.hpp"
 #include "utf8.h"
 
 #include <unicode/locid.h>
 #include <unicode/unistr.h>
 #include <unicode/ustream.h>
 
-#include <iostream>
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
+#include <cstring>
 
-using std::cout, std::endl;
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
 
 
 
@@ -20,21 +24,93 @@ std::wstring widen(string s) {
         utf8::utf8to16(s.begin(), s.end(), back_inserter(wide_out));
         return wide_out;
     } catch (...) {
-        cout << endl << "Error widen: " << s << endl;
+        diagnose(Problem::invalidUTF8, "widen ", s);
     }
 
     return L"";
 }
 
+size_t asciiPrefix(string_view s) {
+    size_t i = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+    for (; i + 16 <= s.size(); i += 16) {
+        const __m128i chunk =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(s.data() + i));
+        if (_mm_movemask_epi8(chunk) != 0)
+            break;
+    }
+#endif
+    for (; i + 8 <= s.size(); i += 8) {
+        uint64_t word;
+        std::memcpy(&word, s.data() + i, sizeof(word));
+        if (word & 0x8080808080808080u)
+            break;
+    }
+    while (i < s.size() && !(s[i] & 0x80))
+        i++;
+    return i;
+}
+
+// The length of the valid sequence of more than one byte at i, 0 if there is
+// none. Overlong forms, surrogates and code points above U+10FFFF are invalid.
+static size_t utf8Sequence(string_view s, size_t i) {
+    const auto at = [&](size_t j) -> uint8_t {
+        return j < s.size() ? uint8_t(s[j]) : 0;
+    };
+    const auto trail = [&](size_t j) { return (at(j) & 0xc0) == 0x80; };
+    const uint8_t lead = at(i), second = at(i + 1);
+    if (lead >= 0xc2 && lead <= 0xdf)
+        return trail(i + 1) ? 2 : 0;
+    if (lead >= 0xe0 && lead <= 0xef) {
+        const uint8_t low = lead == 0xe0 ? 0xa0 : 0x80;
+        const uint8_t high = lead == 0xed ? 0x9f : 0xbf;
+        return second >= low && second <= high && trail(i + 2) ? 3 : 0;
+    }
+    if (lead >= 0xf0 && lead <= 0xf4) {
+        const uint8_t low = lead == 0xf0 ? 0x90 : 0x80;
+        const uint8_t high = lead == 0xf4 ? 0x8f : 0xbf;
+        return second >= low && second <= high && trail(i + 2) &&
+                       trail(i + 3)
+                   ? 4
+                   : 0;
+    }
+    return 0;
+}
+
+bool validUTF8(string_view s) {
+    for (size_t i = asciiPrefix(s); i < s.size();
+         i += asciiPrefix(s.substr(i))) {
+        const size_t length = utf8Sequence(s, i);
+        if (length == 0)
+            return false;
+        i += length;
+    }
+    return true;
+}
+
 void fixUTF8(std::string &str) {
-    try {
-        str += " "; // To avoid not_enough_room
-        std::string temp;
-        utf8::replace_invalid(str.begin(), str.end(), back_inserter(temp));
-        str = temp;
-    } catch (... /*utf8::not_enough_room &e*/) {
-        cout << endl << "Error sani: " << endl << str << endl;
+    if (validUTF8(str))
+        return;
+    string fixed;
+    fixed.reserve(str.size() + 8);
+    for (size_t i = 0; i < str.size();) {
+        const uint8_t lead = uint8_t(str[i]);
+        const size_t length = lead < 0x80 ? 1 : utf8Sequence(str, i);
+        if (length > 0) {
+            fixed.append(str, i, length);
+            i += length;
+            continue;
+        }
+        fixed += "\xEF\xBF\xBD";
+        i++;
+        // One replacement for the sequence of a lead byte, but one for every
+        // stray trail byte
+        if (lead >= 0xc0 && lead <= 0xf7) {
+            while (i < str.size() && (uint8_t(str[i]) & 0xc0) == 0x80)
+                i++;
+        }
     }
+    str = std::move(fixed);
 }
 
 // trim from start (in place)
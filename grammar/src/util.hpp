@@ -1,18 +1,30 @@
 #pragma once
 
+#include <algorithm>
+#include <cctype>
+#include <initializer_list>
+#include <memory_resource>
 #include <ostream>
 #include <string>
+#include <string_view>
 #include <vector>
 using std::ostream, std::wostream;
-using std::string, std::wstring, std::to_string;
+using std::string, std::string_view, std::wstring, std::to_string;
 using std::vector;
 
 //#include <customOperator.h>
 
 std::wstring widen(string s);
 
+// Replaces every invalid sequence by U+FFFD the way utf8::replace_invalid does.
+// Valid strings are left alone without copying them.
 void fixUTF8(std::string &str);
 
+// The number of ASCII bytes s starts with, 16 at a time where SSE2 is there
+size_t asciiPrefix(string_view s);
+
+bool validUTF8(string_view s);
+
 enum Color { blue, red, green, yellow, black, greenblue, purple, grey };
 
 const char *colorToString(const Color color);
@@ -61,12 +73,27 @@ static inline bool has(const string &t, const char *k) {
     return has(t, string(k));
 }
 
+template <> inline bool has(const string_view &t, const string_view &k) {
+    return t.find(k) != string_view::npos;
+}
+
+static inline bool has(const string_view &t, const char *k) {
+    return t.find(k) != string_view::npos;
+}
+
 static inline bool only(const vector<string> &vec, const string &comp) {
     if (vec.size() != 1)
         return false;
     return vec[0] == comp;
 }
 
+static inline bool only(const std::pmr::vector<string_view> &vec,
+                        const string_view &comp) {
+    if (vec.size() != 1)
+        return false;
+    return vec[0] == comp;
+}
+
 static inline string removeSub(const string &in, const string &what) {
     string cp(in);
     size_t pos = std::string::npos;
@@ -75,26 +102,42 @@ static inline string removeSub(const string &in, const string &what) {
     return cp;
 }
 
-static inline bool startsWith(const string &who, const string &prefix) {
+static inline bool startsWith(const string_view &who,
+                              const string_view &prefix) {
     return !who.compare(0, prefix.size(), prefix);
 }
 
-static inline bool endsWith(const string &who, const string &suffix) {
+static inline bool endsWith(const string_view &who, const string_view &suffix) {
     if (suffix.size() > who.size())
         return false;
     return std::equal(suffix.rbegin(), suffix.rend(), who.rbegin());
 }
 
-static inline bool tryEat(string &t, const string &prefix) {
+static inline bool tryEat(string &t, const string_view &prefix) {
+    if (startsWith(t, prefix)) {
+        t.erase(0, prefix.length());
+        return true;
+    }
+    return false;
+}
+static inline bool tryEatB(string &t, const string_view &suffix) {
+    if (endsWith(t, suffix)) {
+        t.resize(t.length() - suffix.length());
+        return true;
+    }
+    return false;
+}
+
+static inline bool tryEat(string_view &t, const string_view &prefix) {
     if (startsWith(t, prefix)) {
-        t = t.substr(prefix.length());
+        t.remove_prefix(prefix.length());
         return true;
     }
     return false;
 }
-static inline bool tryEatB(string &t, const string &suffix) {
+static inline bool tryEatB(string_view &t, const string_view &suffix) {
     if (endsWith(t, suffix)) {
-        t = t.substr(0, t.length() - suffix.length());
+        t.remove_suffix(suffix.length());
         return true;
     }
     return false;
@@ -119,6 +162,16 @@ static inline string trim(const string &s) {
     return s2;
 }
 
+// trim from both ends (view)
+static inline string_view trim(const string_view &s) {
+    size_t begin = 0, end = s.size();
+    while (begin < end && std::isspace((unsigned char)s[begin]))
+        begin++;
+    while (end > begin && std::isspace((unsigned char)s[end - 1]))
+        end--;
+    return s.substr(begin, end - begin);
+}
+
 template <typename K, typename T, typename F>
 static inline vector<K> vecMap(const vector<T> &vec, F f) {
     vector<K> out;
@@ -156,13 +209,8 @@ inline bool isAnyOf(const T &x, const vector<string> &of) {
     return a;
 }*/
 
-static inline void pushUnique(vector<string> &a, const vector<string> &b) {
-    for (const auto &bb : b)
-        if (!has(a, bb))
-            a.push_back(bb);
-}
-
-static inline bool hasAnyOf(const string &x, const vector<string> &of) {
+static inline bool hasAnyOf(const string_view &x,
+                            std::initializer_list<string_view> of) {
     for (const auto &o : of)
         if (has(x, o))
             return true;
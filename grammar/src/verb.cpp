@@ -1,7 +1,6 @@
 #include "verb.hpp"
 
-#include <iostream>
-using std::cout, std::endl;
+#include "diagnostics.hpp"
 
 string Verb::indPres(const Verbspec::Person person, bool plural,
                      const Dictionary &dict, bool forceArtificial) const {
@@ -35,7 +34,7 @@ string Verb::indPres(const Verbspec::Person person, bool plural,
         return "";
 
     default:
-        cout << "Error: TODO: person not supported" << endl;
+        diagnose(Problem::unsupportedPerson);
         return "";
     }
 }
@@ -87,7 +86,7 @@ string Verb::get(const Verbspec &spec, const Dictionary &dict,
 
     if (spec.person == Verbspec::AnyPerson ||
         spec.number == Verbspec::AnyNumber) {
-        cout << "Error: can't use 'any' here." << endl;
+        diagnose(Problem::anyPersonOrNumber);
         return "";
     }
 
@@ -98,12 +97,12 @@ string Verb::get(const Verbspec &spec, const Dictionary &dict,
             return indPres(spec.person, spec.number == Verbspec::Plural, dict,
                            forceArtificial);
         default:
-            cout << "Error: TODO: unknown tempus" << endl;
+            diagnose(Problem::unsupportedTempus);
             break;
         }
         break;
     default:
-        cout << "Error: TODO: unknown mode" << endl;
+        diagnose(Problem::unsupportedMode);
         break;
     }
     return "";
@@ -114,7 +113,7 @@ bool Verb::test(const Verbspec &spec, const Dictionary &dict,
 
     if (spec.person == Verbspec::AnyPerson ||
         spec.number == Verbspec::AnyNumber) {
-        cout << "Error: can't use 'any' here." << endl;
+        diagnose(Problem::anyPersonOrNumber);
         return "";
     }
 
@@ -128,12 +127,12 @@ bool Verb::test(const Verbspec &spec, const Dictionary &dict,
             return res;
         }
         default:
-            cout << "Error: TODO: unknown tempus" << endl;
+            diagnose(Problem::unsupportedTempus);
             break;
         }
         break;
     default:
-        cout << "Error: TODO: unknown mode" << endl;
+        diagnose(Problem::unsupportedMode);
         break;
     }
     return true;
@@ -1,4 +1,5 @@
 #pragma once
+#include "diagnostics.hpp"
 #include "grammar.hpp"
 #include "noun.hpp"
 
@@ -119,8 +120,8 @@ class Verb {
 
     string indPres1Sg() const {
         if (base.present.first.singular.empty()) {
-            cout << "Error: First Person needed!"
-                 << endl; // TODO: Try to get it from infinitive
+            // TODO: Try to get it from infinitive
+            diagnose(Problem::noFirstPerson);
             return "";
         }
         return base.present.first.singular[0];
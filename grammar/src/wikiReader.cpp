@@ -0,0 +1,170 @@
+#include "wikiReader.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+
+#include "stats.hpp"
+#include "wikiScanner.hpp"
+
+namespace parseWiki {
+
+PageReader::PageReader(shared_ptr<istream> in, size_t blockSize, size_t start)
+    : in(in), base(start), begin(0), end(0), blockSize(blockSize),
+      eof(false) {}
+
+bool PageReader::fill() {
+    if (eof)
+        return false;
+    if (begin > 0) {
+        std::memmove(&buf[0], &buf[begin], end - begin);
+        base += begin;
+        end -= begin;
+        begin = 0;
+    }
+    if (buf.size() < end + blockSize)
+        buf.resize(end + blockSize);
+    in->read(&buf[end], blockSize);
+    const size_t got = in->gcount();
+    end += got;
+    if (!*in)
+        eof = true;
+    return got > 0;
+}
+
+size_t PageReader::find(const string_view &what) {
+    size_t searched = 0; // Relative to begin, survives the compaction in fill
+    while (true) {
+        const string_view rest(buf.data() + begin, end - begin);
+        const size_t pos = rest.find(what, searched);
+        if (pos != string_view::npos)
+            return begin + pos;
+        if (rest.size() >= what.size())
+            searched = rest.size() - what.size() + 1;
+        if (!fill())
+            return string_view::npos;
+    }
+}
+
+bool PageReader::nextPage(string_view &page) {
+    const StageTimer timer(Stage::read);
+    const size_t open = find("<page>");
+    if (open == string_view::npos) {
+        begin = end;
+        return false;
+    }
+    begin = open + 6;
+
+    const size_t close = find("</page>");
+    if (close == string_view::npos) {
+        begin = end;
+        return false;
+    }
+    page = string_view(buf.data() + begin, close - begin);
+    begin = close + 7;
+    return true;
+}
+
+// Position of <tag> (or </tag> with close) at or after pos
+static size_t findTag(const string_view &container, const string_view &tag,
+                      bool close, size_t pos) {
+    const string_view lt = close ? "</" : "<";
+    for (; (pos = container.find(lt, pos)) != string_view::npos; pos++) {
+        const size_t name = pos + lt.size();
+        if (container.compare(name, tag.size(), tag) == 0 &&
+            container.compare(name + tag.size(), 1, ">") == 0)
+            return pos;
+    }
+    return string_view::npos;
+}
+
+string_view tagContent(const string_view &container, const string_view &tag) {
+    const size_t start = findTag(container, tag, false, 0);
+    if (start == string_view::npos)
+        return "";
+    const size_t from = start + tag.size() + 2;
+    const size_t stop = findTag(container, tag, true, from);
+    if (stop == string_view::npos)
+        return "";
+    return container.substr(from, stop - from);
+}
+
+string_view textContent(const string_view &page) {
+    size_t pos = 0;
+    while ((pos = page.find("<text", pos)) != string_view::npos) {
+        size_t gt = pos + 5;
+        if (gt < page.size() && page[gt] == ' ')
+            gt = page.find('>', gt);
+        if (gt < page.size() && page[gt] == '>') {
+            const size_t lt = page.find('<', gt + 1);
+            if (lt != string_view::npos &&
+                page.substr(lt, 7) == string_view("</text>"))
+                return page.substr(gt + 1, lt - gt - 1);
+        }
+        pos++;
+    }
+    return "";
+}
+
+static bool readId(const string_view &text, uint64_t &id) {
+    const auto res = std::from_chars(text.data(), text.data() + text.size(), id);
+    return res.ec == std::errc() && res.ptr == text.data() + text.size();
+}
+
+bool pageRevision(const string_view &page, uint64_t &id, uint64_t &revision) {
+    // The page's <id> comes before its <revision>, which has one of its own
+    const size_t rev = findTag(page, "revision", false, 0);
+    if (rev == string_view::npos)
+        return false;
+    return readId(tagContent(page.substr(0, rev), "id"), id) &&
+           readId(tagContent(page.substr(rev), "id"), revision);
+}
+
+PageFilter::PageFilter(const vector<long> &namespaces,
+                       const vector<string> &languages)
+    : namespaces(namespaces) {
+    for (const string &lang : languages)
+        needles.push_back("|" + lang + "}}");
+}
+
+// Whether the page has "|name|" with any whitespace around name, since
+// wantSubsection trims the word class before it compares it
+static bool hasWordClass(const string_view &page, const string_view &name) {
+    for (size_t at = findFast(page, name); at != string_view::npos;
+         at = findFast(page, name, at + 1)) {
+        size_t before = at, after = at + name.size();
+        while (before > 0 && std::isspace((unsigned char)page[before - 1]))
+            before--;
+        while (after < page.size() && std::isspace((unsigned char)page[after]))
+            after++;
+        if (before > 0 && page[before - 1] == '|' && after < page.size() &&
+            page[after] == '|')
+            return true;
+    }
+    return false;
+}
+
+bool PageFilter::accepts(const string_view &page) const {
+    if (!namespaces.empty()) {
+        // Pages without a readable <ns> are kept
+        const string_view ns = tagContent(page, "ns");
+        long n;
+        const auto res = std::from_chars(ns.data(), ns.data() + ns.size(), n);
+        if (res.ec == std::errc() &&
+            std::find(namespaces.begin(), namespaces.end(), n) ==
+                namespaces.end())
+            return false;
+    }
+    if (needles.empty())
+        return true;
+    for (const string &needle : needles)
+        if (findFast(page, needle) != string_view::npos)
+            return true;
+    for (const string_view name : {"Vorname", "Nachname", "Name"})
+        if (hasWordClass(page, name))
+            return true;
+    return false;
+}
+
+} // namespace parseWiki
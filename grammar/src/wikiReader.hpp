@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+using std::istream;
+using std::shared_ptr;
+using std::string, std::string_view;
+using std::vector;
+
+namespace parseWiki {
+
+// A place in the (decompressed) dump where reading can continue. A bz2
+// multistream can only be entered at the start of one of its streams, so that
+// one is decompressed again and the part in front of offset is skipped.
+struct ResumePoint {
+    size_t offset = 0;      // Decompressed bytes in front of it
+    size_t stream = 0;      // Dump file offset of the stream it lies in
+    size_t streamStart = 0; // Decompressed bytes in front of that stream
+};
+
+// Reads the dump in large blocks and hands out the content of every
+// <page>-tag as a view into its buffer. A view is valid until the next call of
+// nextPage.
+class PageReader {
+  private:
+    shared_ptr<istream> in;
+    string buf;
+    size_t base;       // Input offset of buf[0]
+    size_t begin, end; // Unconsumed part of buf
+    const size_t blockSize;
+    bool eof;
+
+    // Moves the unconsumed part to the front and appends the next block
+    bool fill();
+
+    // Searches what in the unconsumed part, reading more blocks if needed
+    size_t find(const string_view &what);
+
+  public:
+    // start is the input offset in is positioned at
+    PageReader(shared_ptr<istream> in, size_t blockSize = 16 * 1024 * 1024,
+               size_t start = 0);
+
+    // Returns false if there are no more pages
+    bool nextPage(string_view &page);
+
+    // Input offset behind the last page
+    size_t offset() const { return base + begin; }
+};
+
+// Content of the first <tag>...</tag> in container or "" if there is none
+string_view tagContent(const string_view &container, const string_view &tag);
+
+// Content of the page's text. Same as matching <text( [^>]*)?>([^<]*)</text>
+string_view textContent(const string_view &page);
+
+// Reads the page id and the id of its revision. Returns false if either is
+// missing.
+bool pageRevision(const string_view &page, uint64_t &id, uint64_t &revision);
+
+// Tells from the raw bytes of a page whether it can contribute to the
+// dictionary, so the others are neither copied nor parsed.
+//
+// A page is kept if its <ns> is one of the namespaces and it mentions one of
+// the languages as "|lang}}", which covers {{Sprache|lang}} as well as
+// {{Wortart|...|lang}}. Pages with a Vorname, Nachname or Name between two
+// "|", with or without spaces around it, are kept regardless of the language
+// since the parser takes names of every language.
+// Skipped pages don't count towards the word classes.
+class PageFilter {
+  private:
+    vector<long> namespaces;
+    vector<string> needles;
+
+  public:
+    // Empty lists accept everything
+    PageFilter(const vector<long> &namespaces = {0},
+               const vector<string> &languages = {"Deutsch"});
+
+    bool accepts(const string_view &page) const;
+};
+
+} // namespace parseWiki
@@ -0,0 +1,139 @@
+#include "wikiScanner.hpp"
+
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace parseWiki {
+
+static const size_t npos = string_view::npos;
+
+size_t findFast(const string_view &text, const string_view &needle,
+                size_t pos) {
+    const size_t n = needle.size();
+    if (n < 2 || pos > text.size() || text.size() - pos < n)
+        return text.find(needle, pos);
+#ifdef __SSE2__
+    const char *data = text.data();
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[n - 1]);
+    const size_t candidates = text.size() - n + 1;
+    for (; pos + 16 <= candidates; pos += 16) {
+        const __m128i a = _mm_loadu_si128((const __m128i *)(data + pos));
+        const __m128i b =
+            _mm_loadu_si128((const __m128i *)(data + pos + n - 1));
+        unsigned mask = _mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last)));
+        while (mask) {
+            const size_t at = pos + __builtin_ctz(mask);
+            if (std::memcmp(data + at + 1, needle.data() + 1, n - 2) == 0)
+                return at;
+            mask &= mask - 1;
+        }
+    }
+#endif
+    return text.find(needle, pos);
+}
+
+bool Literal::next(const string_view &text, size_t from, Match &m) const {
+    const size_t pos = findFast(text, what, from);
+    if (pos == npos)
+        return false;
+    m = {pos, pos + what.size(), ""};
+    return true;
+}
+
+bool AnyOf::next(const string_view &text, size_t from, Match &m) const {
+    const size_t pos = text.find_first_of(chars, from);
+    if (pos == npos)
+        return false;
+    m = {pos, pos + 1, ""};
+    return true;
+}
+
+SectionMatcher::SectionMatcher()
+    : parenFrom(npos), paren(npos), closeFrom(npos), close(npos) {}
+
+bool SectionMatcher::next(const string_view &text, size_t from, Match &m) {
+    for (size_t p = from; (p = findFast(text, "== ", p)) != npos; p++) {
+        // [^\(]+ runs up to the first ( behind "== ". The candidates only move
+        // forward, so most of them can reuse the last search.
+        const size_t title = p + 3;
+        if (parenFrom == npos || title < parenFrom || title > paren) {
+            parenFrom = title;
+            paren = text.find('(', title);
+        }
+        if (paren == npos)
+            return false; // No later candidate has one either
+        if (paren < title + 2 || text[paren - 1] != ' ' ||
+            text.compare(paren, 11, "({{Sprache|") != 0)
+            continue;
+
+        // ([^\}]+) runs up to the first }
+        const size_t lang = paren + 11;
+        if (closeFrom != lang) {
+            closeFrom = lang;
+            close = text.find('}', lang);
+        }
+        if (close == npos || close == lang ||
+            text.compare(close, 7, "}}) ==\n") != 0)
+            continue;
+
+        m = {p, close + 7, text.substr(lang, close - lang)};
+        return true;
+    }
+    return false;
+}
+
+HeadingMatcher::HeadingMatcher(const string_view &open,
+                               const string_view &close)
+    : open(open), close(close), stopFrom(npos), stop(npos) {}
+
+size_t HeadingMatcher::groupEnd(const string_view &text, size_t from) {
+    // ([^\}]|\}\}, \{\{)* stops at the first } that doesn't start "}}, {{".
+    // A group starts right behind "{{", so it never starts inside such a
+    // separator and the last result holds for every position up to its end.
+    if (stopFrom != npos && from >= stopFrom && from <= stop)
+        return stop;
+    stopFrom = from;
+    stop = text.find('}', from);
+    while (stop != npos && text.compare(stop, 6, "}}, {{") == 0)
+        stop = text.find('}', stop + 6);
+    return stop;
+}
+
+bool HeadingMatcher::next(const string_view &text, size_t from, Match &m) {
+    for (size_t p = from; (p = findFast(text, open, p)) != npos; p++) {
+        const size_t group = p + open.size();
+        const size_t end = groupEnd(text, group);
+        if (end == npos)
+            return false; // Every later candidate runs into the end, too
+        if (text.compare(end, close.size(), close) == 0) {
+            m = {p, end + close.size(), text.substr(group, end - group)};
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline bool isWordChar(const char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           (c >= '0' && c <= '9') || c == '_';
+}
+
+bool LinkMatcher::next(const string_view &text, size_t from, Match &m) const {
+    for (size_t p = from; (p = findFast(text, "[[", p)) != npos; p++) {
+        size_t end = p + 2;
+        while (end < text.size() && isWordChar(text[end]))
+            end++;
+        if (end > p + 2 && text.compare(end, 2, "]]") == 0) {
+            m = {p, end + 2, text.substr(p + 2, end - p - 2)};
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace parseWiki
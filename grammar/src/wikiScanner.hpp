@@ -0,0 +1,112 @@
+#pragma once
+
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+using std::string, std::string_view;
+using std::tuple;
+using std::vector;
+
+#include "pageArena.hpp"
+#include "util.hpp"
+
+namespace parseWiki {
+
+// Position of needle in text at or after pos or npos. Compares the first and
+// the last byte of the needle at 16 positions at once where SSE2 is available.
+size_t findFast(const string_view &text, const string_view &needle,
+                size_t pos = 0);
+
+struct Match {
+    size_t begin, end;
+    string_view group;
+};
+
+// The matchers replace the regular expressions the wiki text used to be split
+// with. next finds the leftmost match at or after from, exactly where the
+// regex would have found it.
+
+// A fixed separator like \n|
+struct Literal {
+    const string_view what;
+    Literal(const string_view &what) : what(what) {}
+    bool next(const string_view &text, size_t from, Match &m) const;
+};
+
+// Any of the given characters like ,|;
+struct AnyOf {
+    const string_view chars;
+    AnyOf(const string_view &chars) : chars(chars) {}
+    bool next(const string_view &text, size_t from, Match &m) const;
+};
+
+// == Title ({{Sprache|lang}}) ==\n
+// Same as == [^\(]+ \(\{\{Sprache\|([^\}]+)\}\}\) ==\n
+class SectionMatcher {
+  private:
+    size_t parenFrom, paren, closeFrom, close;
+
+  public:
+    SectionMatcher();
+    bool next(const string_view &text, size_t from, Match &m);
+};
+
+// === {{a}}, {{b}} ===\n and the like, e.g. with open "=== {{" and close
+// "}} ===\n" the same as === \{\{(([^\}]|\}\}, \{\{)*)\}\} ===\n
+class HeadingMatcher {
+  private:
+    const string_view open, close;
+    size_t stopFrom, stop;
+
+    size_t groupEnd(const string_view &text, size_t from);
+
+  public:
+    HeadingMatcher(const string_view &open, const string_view &close);
+    bool next(const string_view &text, size_t from, Match &m);
+};
+
+// [[word]], same as \[\[(\w+)\]\]
+struct LinkMatcher {
+    bool next(const string_view &text, size_t from, Match &m) const;
+};
+
+typedef tuple<string_view, string_view> Part;
+typedef std::pmr::vector<Part> Parts; // Allocated from the page's arena
+
+// Every match followed by the trimmed text up to the next one. With
+// includeFirst, the untrimmed text in front of the first match comes first.
+template <typename M>
+Parts leading(const string_view &text, M matcher,
+              const bool includeFirst = false) {
+    Parts results(scratch());
+    Match m;
+    bool found = matcher.next(text, 0, m);
+    if (includeFirst)
+        results.emplace_back("", text.substr(0, found ? m.begin : text.size()));
+    while (found) {
+        Match n;
+        const bool more = matcher.next(text, m.end, n);
+        const size_t stop = more ? n.begin : text.size();
+        results.emplace_back(m.group, trim(text.substr(m.end, stop - m.end)));
+        m = n;
+        found = more;
+    }
+    return results;
+}
+
+// Every match with the trimmed text in front of it
+template <typename M>
+Parts tailing(const string_view &text, M matcher) {
+    Parts results(scratch());
+    Match m;
+    size_t prev = 0;
+    for (size_t from = 0; matcher.next(text, from, m); from = m.end) {
+        results.emplace_back(m.group, trim(text.substr(prev, m.begin - prev)));
+        prev = m.end;
+    }
+    return results;
+}
+
+} // namespace parseWiki